@@ -0,0 +1,69 @@
+#ifndef BENCH_ASYNCCLIENT_H_
+#define BENCH_ASYNCCLIENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lwip/err.h"
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+typedef struct { uint32_t addr; } ip_addr_t;
+
+/// @brief 主机端连接：发送的数据直接丢弃，receive()/recycle()模拟收到数据与连接回收
+class AsyncClient {
+public:
+    size_t add(const char* data, size_t size, uint8_t flags = TCP_WRITE_FLAG_COPY);
+    size_t write(const char* data, size_t size, uint8_t flags = TCP_WRITE_FLAG_COPY);
+    bool send();
+    size_t get_send_buffer_size();
+    void close(bool now = false);
+    int8_t abort();
+    int id();
+    uint16_t get_remote_port();
+    ip_addr_t get_remote_IP();
+    void set_defer_ack(bool enable);
+    void set_rx_timeout_second(uint32_t timeout);
+    void set_data_received_handler(void (*cb)(void*, void*, size_t), void* arg);
+    void set_error_event_handler(void (*cb)(void*, int8_t), void* arg);
+    void set_ack_event_handler(void (*cb)(void*, size_t, uint32_t), void* arg);
+    void set_disconnected_event_handler(void (*cb)(void*), void* arg);
+    void set_timeout_event_handler(void (*cb)(void*, uint32_t), void* arg);
+    void set_poll_event_handler(void (*cb)(void*), void* arg);
+    void set_recycle_handler(void (*cb)(void*), void* arg);
+
+    /// @brief 模拟收到数据
+    void receive(const char* data, size_t size);
+    /// @brief 模拟连接回收（请求对象归还服务器）
+    void recycle();
+
+private:
+    void (*onData_)(void*, void*, size_t) = nullptr;
+    void* dataArg_ = nullptr;
+    void (*onRecycle_)(void*) = nullptr;
+    void* recycleArg_ = nullptr;
+};
+
+/// @brief 主机端监听：accept()模拟新连接
+class AsyncServer {
+public:
+    explicit AsyncServer(uint16_t port);
+    ~AsyncServer();
+    void set_nodelay(bool enable);
+    void begin();
+    void end();
+    void set_connected_handler(void (*cb)(void*, AsyncClient*), void* arg);
+    void set_clean_handler(void (*cb)(void*), void* arg);
+
+    /// @brief 模拟新连接
+    void accept(AsyncClient* client);
+    /// @brief 按端口查找（AsyncWebServer不公开其监听对象）
+    static AsyncServer* find(uint16_t port);
+
+private:
+    uint16_t port_;
+    void (*onConnect_)(void*, AsyncClient*) = nullptr;
+    void* connectArg_ = nullptr;
+};
+
+#endif // !BENCH_ASYNCCLIENT_H_
@@ -0,0 +1,6 @@
+#ifndef BENCH_ASYNCSERVER_H_
+#define BENCH_ASYNCSERVER_H_
+
+#include "AsyncClient.h"
+
+#endif // !BENCH_ASYNCSERVER_H_
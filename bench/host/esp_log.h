@@ -0,0 +1,15 @@
+#ifndef BENCH_ESP_LOG_H_
+#define BENCH_ESP_LOG_H_
+
+#include <stdio.h>
+
+typedef int esp_err_t;
+const char* esp_err_to_name(esp_err_t code);
+
+#define ESP_LOGE(tag, format, ...) printf("E (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) printf("W (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) do {} while (0)
+#define ESP_LOGD(tag, format, ...) do {} while (0)
+#define ESP_LOGV(tag, format, ...) do {} while (0)
+
+#endif // !BENCH_ESP_LOG_H_
@@ -0,0 +1,26 @@
+#ifndef BENCH_ESP_TIMER_H_
+#define BENCH_ESP_TIMER_H_
+
+#include <stdint.h>
+#include "esp_log.h"
+
+#define ESP_OK 0
+#define ESP_TIMER_TASK 0
+
+typedef struct esp_timer* esp_timer_handle_t;
+typedef struct {
+    void (*callback)(void* arg);
+    void* arg;
+    int dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time();
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+#endif // !BENCH_ESP_TIMER_H_
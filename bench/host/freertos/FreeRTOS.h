@@ -0,0 +1,26 @@
+#ifndef BENCH_FREERTOS_H_
+#define BENCH_FREERTOS_H_
+
+#include <stdint.h>
+
+typedef void* SemaphoreHandle_t;
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef struct { int owner; } portMUX_TYPE;
+
+#define portMAX_DELAY 0xffffffff
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdMS_TO_TICKS(ms) (ms)
+#define tskNO_AFFINITY 0x7fffffff
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+// 基准测试为单线程，临界区为空操作
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+
+#endif // !BENCH_FREERTOS_H_
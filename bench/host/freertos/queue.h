@@ -0,0 +1,11 @@
+#ifndef BENCH_FREERTOS_QUEUE_H_
+#define BENCH_FREERTOS_QUEUE_H_
+
+#include "FreeRTOS.h"
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t size);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait);
+void vQueueDelete(QueueHandle_t queue);
+
+#endif // !BENCH_FREERTOS_QUEUE_H_
@@ -0,0 +1,13 @@
+#ifndef BENCH_FREERTOS_SEMPHR_H_
+#define BENCH_FREERTOS_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t wait);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#endif // !BENCH_FREERTOS_SEMPHR_H_
@@ -0,0 +1,13 @@
+#ifndef BENCH_FREERTOS_TASK_H_
+#define BENCH_FREERTOS_TASK_H_
+
+#include "FreeRTOS.h"
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xTaskCreate(void (*task)(void*), const char* name, uint32_t stack, void* arg, UBaseType_t priority, TaskHandle_t* handle);
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stack, void* arg, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+#endif // !BENCH_FREERTOS_TASK_H_
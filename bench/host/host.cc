@@ -0,0 +1,195 @@
+// 基准测试的主机端实现：连接、定时器、FreeRTOS与mbedtls均为单线程的最小替身
+#include "AsyncClient.h"
+#include "esp_timer.h"
+#include "my_sysInfo.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mbedtls/base64.h"
+#include "mbedtls/md5.h"
+#include "mbedtls/sha1.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+extern const char page404[] asm("_binary_404_html_start");
+const char page404[] asm("_binary_404_html_start") = "<html><body>404</body></html>";
+
+size_t AsyncClient::add(const char* data [[maybe_unused]], size_t size, uint8_t flags [[maybe_unused]]) { return size; }
+size_t AsyncClient::write(const char* data, size_t size, uint8_t flags) { return add(data, size, flags); }
+bool AsyncClient::send() { return true; }
+size_t AsyncClient::get_send_buffer_size() { return 5744; }
+void AsyncClient::close(bool now [[maybe_unused]]) {}
+int8_t AsyncClient::abort() { return ERR_OK; }
+int AsyncClient::id() { return 1; }
+uint16_t AsyncClient::get_remote_port() { return 50000; }
+ip_addr_t AsyncClient::get_remote_IP() { return {0x0100007f}; }
+void AsyncClient::set_defer_ack(bool enable [[maybe_unused]]) {}
+void AsyncClient::set_rx_timeout_second(uint32_t timeout [[maybe_unused]]) {}
+void AsyncClient::set_data_received_handler(void (*cb)(void*, void*, size_t), void* arg) { onData_ = cb; dataArg_ = arg; }
+void AsyncClient::set_error_event_handler(void (*cb)(void*, int8_t) [[maybe_unused]], void* arg [[maybe_unused]]) {}
+void AsyncClient::set_ack_event_handler(void (*cb)(void*, size_t, uint32_t) [[maybe_unused]], void* arg [[maybe_unused]]) {}
+void AsyncClient::set_disconnected_event_handler(void (*cb)(void*) [[maybe_unused]], void* arg [[maybe_unused]]) {}
+void AsyncClient::set_timeout_event_handler(void (*cb)(void*, uint32_t) [[maybe_unused]], void* arg [[maybe_unused]]) {}
+void AsyncClient::set_poll_event_handler(void (*cb)(void*) [[maybe_unused]], void* arg [[maybe_unused]]) {}
+void AsyncClient::set_recycle_handler(void (*cb)(void*), void* arg) { onRecycle_ = cb; recycleArg_ = arg; }
+
+void AsyncClient::receive(const char* data, size_t size)
+{
+    if (onData_) {
+        onData_(dataArg_, (void*)data, size);
+    }
+}
+
+void AsyncClient::recycle()
+{
+    if (onRecycle_) {
+        onRecycle_(recycleArg_);
+    }
+    onData_ = nullptr;
+    onRecycle_ = nullptr;
+}
+
+static std::vector<AsyncServer*> servers;
+
+AsyncServer::AsyncServer(uint16_t port)
+    : port_(port)
+{
+    servers.push_back(this);
+}
+
+AsyncServer::~AsyncServer()
+{
+    std::erase(servers, this);
+}
+
+void AsyncServer::set_nodelay(bool enable [[maybe_unused]]) {}
+void AsyncServer::begin() {}
+void AsyncServer::end() {}
+void AsyncServer::set_connected_handler(void (*cb)(void*, AsyncClient*), void* arg) { onConnect_ = cb; connectArg_ = arg; }
+void AsyncServer::set_clean_handler(void (*cb)(void*) [[maybe_unused]], void* arg [[maybe_unused]]) {}
+
+void AsyncServer::accept(AsyncClient* client)
+{
+    if (onConnect_) {
+        onConnect_(connectArg_, client);
+    }
+}
+
+AsyncServer* AsyncServer::find(uint16_t port)
+{
+    for (auto* server : servers) {
+        if (server->port_ == port) {
+            return server;
+        }
+    }
+    return nullptr;
+}
+
+const char* esp_err_to_name(esp_err_t code [[maybe_unused]]) { return "ESP_FAIL"; }
+
+int64_t esp_timer_get_time()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args [[maybe_unused]], esp_timer_handle_t* handle)
+{
+    *handle = nullptr;
+    return ESP_OK;
+}
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer [[maybe_unused]], uint64_t period [[maybe_unused]]) { return ESP_OK; }
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer [[maybe_unused]], uint64_t timeout [[maybe_unused]]) { return ESP_OK; }
+esp_err_t esp_timer_stop(esp_timer_handle_t timer [[maybe_unused]]) { return ESP_OK; }
+esp_err_t esp_timer_delete(esp_timer_handle_t timer [[maybe_unused]]) { return ESP_OK; }
+
+uint32_t SystemInfo::GetMsSinceStart() { return esp_timer_get_time() / 1000; }
+bool SystemInfo::Timeout(uint32_t start, uint32_t timeout) { return GetMsSinceStart() - start > timeout; }
+
+// 单线程：信号量只计数，不会阻塞（不创建后台任务，读取走同步路径）
+struct HostSemaphore {
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+static SemaphoreHandle_t createSemaphore(UBaseType_t max, UBaseType_t initial)
+{
+    return new HostSemaphore{initial, max};
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return createSemaphore(1, 0); }
+SemaphoreHandle_t xSemaphoreCreateMutex() { return createSemaphore(1, 1); }
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) { return createSemaphore(max, initial); }
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    auto* sem = (HostSemaphore*)semaphore;
+    if (sem->count >= sem->max) {
+        return pdFALSE;
+    }
+    sem->count++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t wait [[maybe_unused]])
+{
+    auto* sem = (HostSemaphore*)semaphore;
+    if (sem->count == 0) {
+        return pdFALSE;
+    }
+    sem->count--;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete (HostSemaphore*)semaphore; }
+QueueHandle_t xQueueCreate(UBaseType_t length [[maybe_unused]], UBaseType_t size [[maybe_unused]]) { return nullptr; }
+BaseType_t xQueueSend(QueueHandle_t queue [[maybe_unused]], const void* item [[maybe_unused]], TickType_t wait [[maybe_unused]]) { return pdFALSE; }
+BaseType_t xQueueReceive(QueueHandle_t queue [[maybe_unused]], void* item [[maybe_unused]], TickType_t wait [[maybe_unused]]) { return pdFALSE; }
+void vQueueDelete(QueueHandle_t queue [[maybe_unused]]) {}
+TaskHandle_t xTaskGetCurrentTaskHandle() { return (void*)1; }
+BaseType_t xTaskCreate(void (*task)(void*) [[maybe_unused]], const char* name [[maybe_unused]], uint32_t stack [[maybe_unused]], void* arg [[maybe_unused]], UBaseType_t priority [[maybe_unused]], TaskHandle_t* handle [[maybe_unused]]) { return pdFALSE; }
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stack, void* arg, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core [[maybe_unused]]) { return xTaskCreate(task, name, stack, arg, priority, handle); }
+void vTaskDelete(TaskHandle_t task [[maybe_unused]]) {}
+uint32_t ulTaskNotifyTake(BaseType_t clear [[maybe_unused]], TickType_t wait [[maybe_unused]]) { return 1; }
+BaseType_t xTaskNotifyGive(TaskHandle_t task [[maybe_unused]]) { return pdTRUE; }
+
+// 摘要仅需确定性，不参与计时的路径（认证、ETag）
+template <typename Context>
+static void digestUpdate(Context* ctx, const unsigned char* input, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        ctx->state[i % sizeof(ctx->state)] = ctx->state[i % sizeof(ctx->state)] * 31 + input[i];
+    }
+}
+
+void mbedtls_md5_init(mbedtls_md5_context* ctx) { memset(ctx, 0, sizeof(*ctx)); }
+int mbedtls_md5_starts(mbedtls_md5_context* ctx) { memset(ctx, 0, sizeof(*ctx)); return 0; }
+int mbedtls_md5_update(mbedtls_md5_context* ctx, const unsigned char* input, size_t size) { digestUpdate(ctx, input, size); return 0; }
+int mbedtls_md5_finish(mbedtls_md5_context* ctx, unsigned char* output) { memcpy(output, ctx->state, 16); return 0; }
+void mbedtls_md5_free(mbedtls_md5_context* ctx [[maybe_unused]]) {}
+void mbedtls_sha1_init(mbedtls_sha1_context* ctx) { memset(ctx, 0, sizeof(*ctx)); }
+int mbedtls_sha1_starts(mbedtls_sha1_context* ctx) { memset(ctx, 0, sizeof(*ctx)); return 0; }
+int mbedtls_sha1_update(mbedtls_sha1_context* ctx, const unsigned char* input, size_t size) { digestUpdate(ctx, input, size); return 0; }
+int mbedtls_sha1_finish(mbedtls_sha1_context* ctx, unsigned char* output) { memcpy(output, ctx->state, 20); return 0; }
+void mbedtls_sha1_free(mbedtls_sha1_context* ctx [[maybe_unused]]) {}
+
+int mbedtls_base64_encode(unsigned char* dst, size_t size, size_t* written, const unsigned char* src, size_t length)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t need = (length + 2) / 3 * 4;
+    *written = need + 1;
+    if (dst == nullptr || size < need + 1) {
+        return -0x002A;
+    }
+    size_t o = 0;
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t v = src[i] << 16 | (i + 1 < length ? src[i + 1] << 8 : 0) | (i + 2 < length ? src[i + 2] : 0);
+        dst[o++] = table[v >> 18 & 63];
+        dst[o++] = table[v >> 12 & 63];
+        dst[o++] = i + 1 < length ? table[v >> 6 & 63] : '=';
+        dst[o++] = i + 2 < length ? table[v & 63] : '=';
+    }
+    dst[o] = 0;
+    *written = o;
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_LWIP_ERR_H_
+#define BENCH_LWIP_ERR_H_
+
+#include <stdint.h>
+
+typedef int8_t err_t;
+
+#define ERR_OK 0
+
+#endif // !BENCH_LWIP_ERR_H_
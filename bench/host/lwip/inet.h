@@ -0,0 +1,8 @@
+#ifndef BENCH_LWIP_INET_H_
+#define BENCH_LWIP_INET_H_
+
+#include <arpa/inet.h>
+
+#define IPADDR4_INIT(addr) {addr}
+
+#endif // !BENCH_LWIP_INET_H_
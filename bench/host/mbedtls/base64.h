@@ -0,0 +1,8 @@
+#ifndef BENCH_MBEDTLS_BASE64_H_
+#define BENCH_MBEDTLS_BASE64_H_
+
+#include <stddef.h>
+
+int mbedtls_base64_encode(unsigned char* dst, size_t size, size_t* written, const unsigned char* src, size_t length);
+
+#endif // !BENCH_MBEDTLS_BASE64_H_
@@ -0,0 +1,14 @@
+#ifndef BENCH_MBEDTLS_MD5_H_
+#define BENCH_MBEDTLS_MD5_H_
+
+#include <stddef.h>
+
+typedef struct { unsigned char state[128]; } mbedtls_md5_context;
+
+void mbedtls_md5_init(mbedtls_md5_context* ctx);
+int mbedtls_md5_starts(mbedtls_md5_context* ctx);
+int mbedtls_md5_update(mbedtls_md5_context* ctx, const unsigned char* input, size_t size);
+int mbedtls_md5_finish(mbedtls_md5_context* ctx, unsigned char* output);
+void mbedtls_md5_free(mbedtls_md5_context* ctx);
+
+#endif // !BENCH_MBEDTLS_MD5_H_
@@ -0,0 +1,14 @@
+#ifndef BENCH_MBEDTLS_SHA1_H_
+#define BENCH_MBEDTLS_SHA1_H_
+
+#include <stddef.h>
+
+typedef struct { unsigned char state[128]; } mbedtls_sha1_context;
+
+void mbedtls_sha1_init(mbedtls_sha1_context* ctx);
+int mbedtls_sha1_starts(mbedtls_sha1_context* ctx);
+int mbedtls_sha1_update(mbedtls_sha1_context* ctx, const unsigned char* input, size_t size);
+int mbedtls_sha1_finish(mbedtls_sha1_context* ctx, unsigned char* output);
+void mbedtls_sha1_free(mbedtls_sha1_context* ctx);
+
+#endif // !BENCH_MBEDTLS_SHA1_H_
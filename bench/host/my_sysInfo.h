@@ -0,0 +1,12 @@
+#ifndef BENCH_MY_SYSINFO_H_
+#define BENCH_MY_SYSINFO_H_
+
+#include <stdint.h>
+
+class SystemInfo {
+public:
+    static uint32_t GetMsSinceStart();
+    static bool Timeout(uint32_t start, uint32_t timeout);
+};
+
+#endif // !BENCH_MY_SYSINFO_H_
@@ -0,0 +1,7 @@
+// 设备端经ESP-IDF头文件间接包含的标准库头文件，主机端构建时强制包含
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <functional>
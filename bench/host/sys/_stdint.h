@@ -0,0 +1,6 @@
+#ifndef BENCH_SYS_STDINT_H_
+#define BENCH_SYS_STDINT_H_
+
+#include <stdint.h>
+
+#endif // !BENCH_SYS_STDINT_H_
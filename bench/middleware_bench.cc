@@ -0,0 +1,70 @@
+// 中间件与过滤器的路由开销对比：N条路由由同一守卫保护，分别以setFilter()与use()安装
+// 请求经AsyncServer/AsyncClient的回调完整走一遍（解析、路由、前置中间件、处理器），响应数据直接丢弃
+#include "AsyncWebServer.h"
+#include "middleware/AsyncMiddleware.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static bool guard(AsyncWebServerRequest* req)
+{
+    return req->hasHeader("Host");
+}
+
+static void onRoute(AsyncWebServerRequest* req)
+{
+    req->send(204);
+}
+
+/// @brief 以port启动服务器并注册routes条路由，最后一条为被访问的路由
+static AsyncWebServer* build(uint16_t port, int routes, bool filter)
+{
+    auto* server = new AsyncWebServer(port);
+    for (int i = 0; i < routes; i++) {
+        std::string uri = "/api/r" + std::to_string(i);
+        auto& handler = server->on(uri.c_str(), HTTP_GET, onRoute);
+        if (filter) {
+            handler.setFilter(guard);
+        } else {
+            handler.use(middleware(guard));
+        }
+    }
+    server->begin();
+    return server;
+}
+
+/// @return 每个请求的平均耗时（纳秒）
+static double run(uint16_t port, const std::string& raw, int count)
+{
+    auto* listener = AsyncServer::find(port);
+    AsyncClient client;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        listener->accept(&client);
+        client.receive(raw.data(), raw.size());
+        client.recycle();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+int main(int argc, char** argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : 200000;
+    printf("%-8s %-12s %-12s %-10s %s\n", "routes", "filter(ns)", "use(ns)", "delta(ns)", "cache hits(filter/use)");
+    uint16_t port = 8000;
+    for (int routes : {1, 8, 32, 128}) {
+        std::string raw = "GET /api/r" + std::to_string(routes - 1) + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+        auto* filtered = build(port++, routes, true);
+        auto* chained = build(port++, routes, false);
+        run(port - 2, raw, count / 10);
+        run(port - 1, raw, count / 10);
+        double filterNs = run(port - 2, raw, count);
+        double chainNs = run(port - 1, raw, count);
+        printf("%-8d %-12.0f %-12.0f %-10.0f %u/%u\n", routes, filterNs, chainNs, filterNs - chainNs,
+               filtered->routeCacheHits(), chained->routeCacheHits());
+        delete filtered;
+        delete chained;
+    }
+    return 0;
+}
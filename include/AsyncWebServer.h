@@ -4,7 +4,13 @@
 #include "AsyncServer.h"
 #include "../src/StringArray.h"
 #include "../src/handler/AsyncCallbackWebHandler.h"
+#include "../src/middleware/AsyncMiddleware.h"
 #include "../src/rewrite/AsyncWebRewrite.h"
+#include "../src/router/AsyncRouter.h"
+#include "../src/router/AsyncRouteCache.h"
+#include "../src/router/AsyncMountTable.h"
+#include <unordered_map>
+#include <vector>
 
 class AsyncWebServer;
 class AsyncWebServerRequest;
@@ -25,6 +31,10 @@ public:
     ~AsyncWebServer();
     
     void begin() {
+        for (auto* handler : handlers_) {
+            handler->begin();
+        }
+        generation_++;
         server_.set_nodelay(true);
         server_.begin();
     }
@@ -32,8 +42,15 @@ public:
         server_.end();
     }
     void reset() {
+        exactRewrites_.clear();
+        patternRewrites_.clear();
         rewrites_.free();
+        router_.clear();
+        mounts_.clear();
+        scanned_.clear();
         handlers_.free();
+        use(nullptr);
+        generation_++;
         if (defaultHandler_) {
             defaultHandler_->onRequest(nullptr);
             defaultHandler_->onUpload(nullptr);
@@ -56,24 +73,52 @@ public:
     AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onReq, ArUploadHandlerFunction onUpload);
     AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onReq, ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody);
 
+    void use(AsyncMiddleware* middleware);
+
     AsyncStaticWebHandler& serveStatic(const char* uri, const char* path, const char* cache_ctrl);
 
     void onNotFound(ArRequestHandlerFunction fn);
     void onFileUpload(ArUploadHandlerFunction fn);
     void onRequestBody(ArBodyHandlerFunction fn);
+    void setDateHeader(bool enable);
+    /// @brief 路由缓存的命中次数
+    uint32_t routeCacheHits() const {
+        return routeCache_.hits();
+    }
+    /// @brief 路由缓存的未命中次数
+    uint32_t routeCacheMisses() const {
+        return routeCache_.misses();
+    }
 
 
 protected:
     friend class AsyncWebServerRequest;
+    friend class AsyncWebHandler;
 
+    void indexHandler(AsyncWebHandler* handler);
+    void unindexHandler(AsyncWebHandler* handler);
+    void reindexHandler(AsyncWebHandler* handler);
     AsyncWebServerRequest* allocateRequest(AsyncClient* client);
     void internalHandleDisconnect(AsyncWebServerRequest* req);
-    void internalAttachHandler(AsyncWebServerRequest* req);
-    void internalRewriteRequest(AsyncWebServerRequest* req);
+    void internalRouteRequest(AsyncWebServerRequest* req);
+    bool internalAttachHandler(AsyncWebServerRequest* req);
+    bool internalRewriteRequest(AsyncWebServerRequest* req);
+    bool internalBeforeRequest(AsyncWebServerRequest* req);
+    void internalAfterRequest(AsyncWebServerRequest* req, AsyncWebServerResponse* response);
 
     AsyncServer     server_;                            // 异步TCP服务器
-    LinkedList<AsyncWebRewrite*>    rewrites_;          // URL重写规则链
-    LinkedList<AsyncWebHandler*>    handlers_;          // 处理器链
+    LinkedList<AsyncWebRewrite*>    rewrites_;          // URL重写规则链（持有全部规则）
+    std::unordered_map<std::string, std::vector<AsyncWebRewrite*>> exactRewrites_;  // 完全匹配的重写规则（按原始URL索引，按注册顺序排列）
+    std::vector<AsyncWebRewrite*>   patternRewrites_;   // 前缀与模式重写规则（按注册顺序逐个检测）
+    uint32_t                        rewriteOrder_{0};   // 下一重写规则的注册序号
+    LinkedList<AsyncWebHandler*>    handlers_;          // 处理器链（持有全部处理器）
+    AsyncRouter                     router_;            // 路由树（索引URI为路径模式的处理器）
+    AsyncMountTable                 mounts_;            // 静态资源挂载表（每个URL只检测前缀最长的挂载点）
+    std::vector<std::pair<uint32_t, AsyncWebHandler*>> scanned_;    // 无法索引的处理器及其注册序号（按注册顺序逐个检测）
+    uint32_t                        order_{0};          // 下一处理器的注册序号
+    AsyncRouteCache                 routeCache_;        // 路由缓存（方法与URL -> 重写与处理器绑定结果）
+    uint32_t                        generation_{1};     // 路由表版本（处理器、重写规则变化时递增，使路由缓存失效）
+    AsyncMiddleware*                middleware_{nullptr};   // 服务器级中间件链（所有请求，包括未匹配的请求）
     AsyncCallbackWebHandler*        defaultHandler_;    // 默认处理器（处理未被处理器链匹配项）
     std::atomic<AsyncWebServerRequest*> pool_{nullptr}; // 请求池 
 };
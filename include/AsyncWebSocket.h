@@ -119,6 +119,7 @@ public:
         if (eventHandler_) eventHandler_(this, client, type, arg, data, len);
     }
     virtual bool canHandle(AsyncWebServerRequest* req) override final;
+    virtual bool mayHandle(const std::string& url, uint8_t method) const override final;
     virtual void handleRequest(AsyncWebServerRequest* req) override final;
 
     void cleanBuffers();
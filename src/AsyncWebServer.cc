@@ -3,6 +3,9 @@
 #include "../src/rewrite/AsyncWebRewrite.h"
 #include "../src/handler/AsyncWebHandler.h"
 #include "../src/handler/AsyncCallbackWebHandler.h"
+#include "../src/header/DateHeader.h"
+#include "../src/parameter/AsyncWebParameter.h"
+#include <algorithm>
 #include <atomic>
 
 #define TAG "AsyncWebServer"
@@ -66,16 +69,36 @@ AsyncWebServer::~AsyncWebServer()
     }
 }
 
-/// @brief 添加URL重写规则
+/// @brief 添加URL重写规则（完全匹配的规则以哈希表索引，其余（含自定义匹配的规则）按注册顺序逐个检测）
 AsyncWebRewrite& AsyncWebServer::addRewrite(AsyncWebRewrite* rewrite)
 {
     rewrites_.add(rewrite);
+    generation_++;
+    rewrite->order_ = rewriteOrder_++;
+    if (rewrite->kind() == REWRITE_EXACT) {
+        exactRewrites_[rewrite->from()].push_back(rewrite);
+    } else {
+        patternRewrites_.push_back(rewrite);
+    }
     return *rewrite;
 }
 
 /// @brief 删除URL重写规则
 bool AsyncWebServer::removeRewrite(AsyncWebRewrite* rewrite)
 {
+    if (rewrite->kind() == REWRITE_EXACT) {
+        auto found = exactRewrites_.find(rewrite->from());
+        if (found != exactRewrites_.end()) {
+            auto& list = found->second;
+            list.erase(std::remove(list.begin(), list.end(), rewrite), list.end());
+            if (list.empty()) {
+                exactRewrites_.erase(found);
+            }
+        }
+    } else {
+        patternRewrites_.erase(std::remove(patternRewrites_.begin(), patternRewrites_.end(), rewrite), patternRewrites_.end());
+    }
+    generation_++;
     return rewrites_.remove(rewrite);
 }
 
@@ -84,19 +107,74 @@ AsyncWebRewrite& AsyncWebServer::rewrite(const char* from, const char* to)
     return addRewrite(new AsyncWebRewrite(from, to));
 }
 
-/// @brief 添加处理器
+/// @brief 添加处理器（URI为路径模式的处理器加入路由树，静态资源处理器加入挂载表，其余按注册顺序逐个检测）
 AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) 
 {
     handlers_.add(handler);
+    generation_++;
+    handler->server_ = this;
+    handler->order_ = order_++;
+    indexHandler(handler);
     return *handler;
 }
 
 /// @brief 删除处理器
 bool AsyncWebServer::removeHandler(AsyncWebHandler* handler) 
 {
+    if (handler->server_ == this) {
+        unindexHandler(handler);
+        handler->server_ = nullptr;
+    }
+    generation_++;
     return handlers_.remove(handler);
 }
 
+/// @brief 按处理器当前的URI与方法建立索引（使用其原注册序号）
+void AsyncWebServer::indexHandler(AsyncWebHandler* handler)
+{
+    auto* pattern = handler->routePattern();
+    auto* mount = handler->mountPoint();
+    if (mount != nullptr) {
+        mounts_.add(*mount, handler, handler->order_);
+    } else if (pattern != nullptr && AsyncRouter::routable(*pattern)) {
+        router_.add(*pattern, handler->routeMethods(), handler, handler->order_);
+    } else {
+        auto pos = std::lower_bound(scanned_.begin(), scanned_.end(), handler->order_, [](const std::pair<uint32_t, AsyncWebHandler*>& item, uint32_t order) {
+            return item.first < order;
+        });
+        scanned_.emplace(pos, handler->order_, handler);
+    }
+}
+
+/// @brief 删除处理器的索引
+void AsyncWebServer::unindexHandler(AsyncWebHandler* handler)
+{
+    if (!router_.remove(handler) && !mounts_.remove(handler)) {
+        auto found = std::find_if(scanned_.begin(), scanned_.end(), [handler](const std::pair<uint32_t, AsyncWebHandler*>& item) {
+            return item.second == handler;
+        });
+        if (found != scanned_.end()) {
+            scanned_.erase(found);
+        }
+    }
+}
+
+/// @brief 已注册处理器的URI或方法改变后重新建立索引
+void AsyncWebServer::reindexHandler(AsyncWebHandler* handler)
+{
+    unindexHandler(handler);
+    indexHandler(handler);
+    generation_++;
+}
+
+/// @brief URI或方法改变后由派生类调用：已注册时由所属服务器重新索引，注册顺序不变
+void AsyncWebHandler::reindex()
+{
+    if (server_ != nullptr) {
+        server_->reindexHandler(this);
+    }
+}
+
 /// @brief 注册HTTP路由
 /// @param uri 监听路径
 /// @param onReq 主请求处理回调
@@ -157,6 +235,14 @@ AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodCom
     return *handler;
 }
 
+/// @brief 设置服务器级中间件链（由middleware()创建，服务器接管其内存，再次调用时替换之前的链，nullptr取消）
+/// 前置阶段先于处理器的认证与中间件执行，后置阶段后于处理器的中间件执行
+void AsyncWebServer::use(AsyncMiddleware* middleware)
+{
+    delete middleware_;
+    middleware_ = middleware;
+}
+
 /// @brief 提供静态文件服务
 /// @param uri 监听URI路径
 /// @param path 文件系统中的实际目录
@@ -187,30 +273,210 @@ void AsyncWebServer::onRequestBody(ArBodyHandlerFunction fn)
     defaultHandler_->onBody(fn);
 }
 
+/// @brief 启用/禁用响应中的Date头（服务器级缓存，每秒刷新一次，各响应直接复用）
+/// @note 需先完成系统时间同步（如SNTP），时钟未同步时不发送Date头
+void AsyncWebServer::setDateHeader(bool enable)
+{
+    if (enable) {
+        DateHeader::Instance().start();
+    } else {
+        DateHeader::Instance().stop();
+    }
+}
 
-/// @brief 检查请求是否匹配重写规则，匹配时进行重写
-void AsyncWebServer::internalRewriteRequest(AsyncWebServerRequest* req)
+/// @brief 重写URL并绑定处理器（先查路由缓存，仅由方法与URL决定的结果存入缓存）
+void AsyncWebServer::internalRouteRequest(AsyncWebServerRequest* req)
 {
-    for (const auto& rewrite : rewrites_) {
-        if (rewrite->match(req)) {
-            req->url_ = rewrite->toUrl();
-            auto params = rewrite->params();
-            req->addGetParams(params.c_str(), params.c_str() + params.length());
+    auto hash = AsyncRouteCache::hash(req->method_, req->url_);
+    auto* cached = routeCache_.find(hash, req->method_, req->url_, generation_);
+    if (cached != nullptr) {
+        if (cached->rewritten) {
+            req->url_ = cached->target;
+            for (const auto& param : cached->params) {
+                req->addParam(new AsyncWebParameter(param.first, param.second));
+            }
+        }
+        for (const auto& param : cached->pathParams) {
+            req->addPathParam(param.c_str(), param.length());
         }
+        req->addInterestingHeader("ANY");
+        req->handler_ = cached->handler;
+        return;
+    }
+
+    auto url = req->url_;
+    auto params = req->params_.length();
+    auto cacheable = internalRewriteRequest(req);
+    cacheable = internalAttachHandler(req) && cacheable;
+    auto* entry = cacheable ? routeCache_.slot(hash) : nullptr;
+    if (entry == nullptr) {
+        return;
+    }
+    entry->generation = generation_;
+    entry->hash = hash;
+    entry->method = req->method_;
+    entry->rewritten = req->url_ != url;
+    entry->url = std::move(url);
+    entry->target = entry->rewritten ? req->url_ : empty_string;
+    entry->params.clear();
+    for (auto* param : req->params_) {
+        if (params > 0) {
+            params--;
+            continue;
+        }
+        entry->params.emplace_back(param->name(), param->value());
+    }
+    entry->pathParams.clear();
+    for (auto* param : req->pathParams_) {
+        entry->pathParams.push_back(*param);
+    }
+    entry->handler = req->handler_;
+}
+
+/// @brief 检查请求是否匹配重写规则，以注册最早的命中规则进行重写
+/// 命中规则设置了setChaining(true)时，以重写后的URL继续检测注册晚于它的规则
+/// @return 结果是否仅由URL决定（未调用任何过滤器），可存入路由缓存
+bool AsyncWebServer::internalRewriteRequest(AsyncWebServerRequest* req)
+{
+    bool cacheable = true;
+    uint32_t from = 0;      // 只检测注册序号不小于from的规则
+    AsyncRewriteCaptures captures;
+    while (true) {
+        AsyncWebRewrite* hit = nullptr;
+        auto found = exactRewrites_.find(req->url_);
+        if (found != exactRewrites_.end()) {
+            for (auto* rewrite : found->second) {
+                if (rewrite->order_ < from) {
+                    continue;
+                }
+                cacheable = cacheable && !rewrite->hasFilter();
+                if (rewrite->filter(req)) {
+                    hit = rewrite;
+                    break;
+                }
+            }
+        }
+        for (auto* rewrite : patternRewrites_) {
+            if (hit != nullptr && rewrite->order_ > hit->order_) {
+                break;
+            }
+            if (rewrite->order_ < from) {
+                continue;
+            }
+            if (rewrite->kind() == REWRITE_CUSTOM) {
+                cacheable = false;      // 自定义匹配可能取决于请求状态
+                if (rewrite->match(req)) {
+                    hit = rewrite;
+                    break;
+                }
+                continue;
+            }
+            if (!rewrite->capture(req->url_, captures)) {
+                continue;
+            }
+            cacheable = cacheable && !rewrite->hasFilter();
+            if (rewrite->filter(req)) {
+                hit = rewrite;
+                break;
+            }
+        }
+        if (hit == nullptr) {
+            return cacheable;
+        }
+        if (hit->kind() == REWRITE_EXACT || hit->kind() == REWRITE_CUSTOM) {
+            captures.count = 0;
+        }
+        hit->apply(req, captures);
+        if (!hit->chaining()) {
+            return cacheable;
+        }
+        from = hit->order_ + 1;
     }
 }
 
 ///  @brief 为请求绑定合适的处理器
-void AsyncWebServer::internalAttachHandler(AsyncWebServerRequest* req)
+/// 先在路由树中查找，再逐个检测注册早于命中路由的其他处理器，保证与按注册顺序逐个检测的结果一致
+/// @return 结果是否仅由方法与URL决定（未调用过滤器，且未检测可能处理该URL的其他处理器），可存入路由缓存
+bool AsyncWebServer::internalAttachHandler(AsyncWebServerRequest* req)
 {
-    for (const auto& handler : handlers_) {
+    AsyncRouteMatch match;
+    router_.match(req, req->url_, req->method_, match);
+    bool cacheable = !match.filtered;
+    // 挂载表中前缀最长的挂载点按各自的注册顺序与其他逐个检测的处理器一起检测，前缀较短的挂载点不检测
+    auto mounts = mounts_.find(req->url_, req->method_);
+    auto mount = mounts.begin();
+    auto probe = [req, &cacheable](AsyncWebHandler* handler) {
+        cacheable = false;
         if (handler->filter(req) && handler->canHandle(req)) {
             req->handler_ = handler;
-            return;
+            return true;
+        }
+        return false;
+    };
+    // 检测注册序号小于order的挂载点（过滤器拒绝或文件不存在时继续检测前缀相同的下一个）
+    auto probeMounts = [&](uint32_t order) {
+        for (; mount != mounts.end() && mount->order < order; ++mount) {
+            if (mount->handler->mayHandle(req->url_, req->method_) && probe(mount->handler)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (const auto& item : scanned_) {
+        if (item.first > match.order) {
+            break;
+        }
+        if (probeMounts(item.first)) {
+            return false;
+        }
+        if (item.second->mayHandle(req->url_, req->method_) && probe(item.second)) {
+            return false;
         }
     }
+    if (probeMounts(match.order)) {
+        return false;
+    }
+    if (match.handler != nullptr) {
+        for (uint8_t i = 0; i < match.count; i++) {
+            req->addPathParam(req->url_.c_str() + match.params[i][0], match.params[i][1]);
+        }
+        req->addInterestingHeader("ANY");
+        req->handler_ = match.handler;
+        return cacheable;
+    }
     req->addInterestingHeader("ANY");
     req->handler_ = defaultHandler_;
+    return cacheable;
+}
+
+/// @brief 请求头解析完成后依次执行服务器的中间件、处理器的认证与中间件
+/// @return false表示已发送响应，不再调用处理器
+bool AsyncWebServer::internalBeforeRequest(AsyncWebServerRequest* req)
+{
+    if (middleware_ != nullptr && !middleware_->before(req)) {
+        return false;
+    }
+    auto* handler = req->handler_;
+    if (handler == nullptr) {
+        return true;
+    }
+    req->middleware_ = handler->middleware_;
+    if (handler->hasAuthentication() && !req->authenticate(handler->username_.c_str(), handler->password_.c_str())) {
+        req->requestAuthentication();
+        return false;
+    }
+    return req->middleware_ == nullptr || req->middleware_->before(req);
+}
+
+/// @brief 响应开始发送之前依次执行处理器与服务器中间件的后置阶段
+void AsyncWebServer::internalAfterRequest(AsyncWebServerRequest* req, AsyncWebServerResponse* response)
+{
+    if (req->middleware_ != nullptr) {
+        req->middleware_->after(req, response);
+    }
+    if (middleware_ != nullptr) {
+        middleware_->after(req, response);
+    }
 }
 
 /// @brief 处理客户端断开连接的情况
@@ -154,6 +154,7 @@ public:
             if (i++ == index) {
                 return &(it->value());
             }
+            it = it->next;
         }
         return nullptr;
     }
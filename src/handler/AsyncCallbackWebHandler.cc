@@ -1,8 +1,65 @@
 #include "AsyncCallbackWebHandler.h"
 #include "../request/AsyncWebServerRequest.h"
+#include "../router/AsyncRouter.h"
 
 #define TAG "AsyncCallbackWebHandler"
 
+/// @brief 为处理器绑定目标URI（以^开头并且以$结尾时自动标识为正则模式）
+void AsyncCallbackWebHandler::setUri(const std::string &uri)
+{
+    uri_ = uri;
+    isRegex_ = uri.starts_with("^") && uri.ends_with("$");
+#if CONFIG_ENABLE_REGEX
+    if (isRegex_) {
+        regex_.assign(uri_, std::regex::ECMAScript | std::regex::optimize);
+    }
+#endif
+    reindex();
+}
+
+/// @brief 设置处理器支持的HTTP方法
+void AsyncCallbackWebHandler::setMethod(WebRequestMethodComposite m)
+{
+    method_ = m;
+    reindex();
+}
+
+/// @brief 逐字符比较URI模式与URL（不产生临时字符串，模式语法同AsyncRouter）
+/// 参数段匹配一个非空路径段，*匹配任意剩余部分（其后为后缀），其余情况URL须在模式结束处结束或后接'/'
+/// @param req 不为nullptr时将参数段捕获为路径参数
+bool AsyncCallbackWebHandler::matchPath(const std::string& pattern, const std::string& url, AsyncWebServerRequest* req)
+{
+    size_t i = 0, j = 0;
+    while (i < pattern.length()) {
+        uint8_t type;
+        auto param = AsyncRouter::paramLength(pattern, i, type);
+        if (param) {
+            auto start = j;
+            while (j < url.length() && url[j] != '/') {
+                j++;
+            }
+            if (!AsyncRouter::acceptParam(type, url.c_str() + start, j - start)) {
+                return false;
+            }
+            if (req) {
+                req->addPathParam(url.c_str() + start, j - start);
+            }
+            i += param;
+            continue;
+        }
+        if (pattern[i] == '*') {
+            auto suffix = std::string_view(pattern).substr(i + 1);
+            return url.length() - j >= suffix.length() && url.ends_with(suffix);
+        }
+        if (j == url.length() || url[j] != pattern[i]) {
+            return false;
+        }
+        i++;
+        j++;
+    }
+    return j == url.length() || url[j] == '/';
+}
+
 
 /// @brief 判断请求能否被处理
 bool  AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* req)
@@ -10,58 +67,53 @@ bool  AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* req)
     if (!onRequest_ || uri_.length() == 0) {
         return false;
     }
-    if (!(method_ & req->method_)) {
+    // HEAD请求由GET处理函数处理，响应只发送头部
+    auto method = req->method_ == HTTP_HEAD ? (HTTP_GET | HTTP_HEAD) : req->method_;
+    if (!(method_ & method)) {
         return false;
     }
 
 #if CONFIG_ENABLE_REGEX
     if (isRegex_) {
-        std::regex pattern(uri_.c_str());
         std::smatch matches;
-        std::string str = req->url_;
-        auto size = matches.size();
-        if (std::regex_search(str, size, pattern)) {
-            for (size_t i = 0; i < size; ++i) {
-                req->addPathParam(matches[i].str().c_str());
-            }
-        } else {
+        if (!std::regex_search(req->url_, matches, regex_)) {
             return false;
         }
+        for (size_t i = 1; i < matches.size(); i++) {
+            req->addPathParam(req->url_.c_str() + matches.position(i), matches.length(i));
+        }
     } else
 #endif
-    // 通配模式
-    if (uri_.starts_with("/*.")) {
-        // 包含特定结尾
-        std::string uriTemplate = uri_.substr(uri_.find_last_of("."));
-        if (!req->url_.ends_with(uriTemplate)) {
+    {
+        // 确认匹配后再捕获路径参数
+        if (!matchPath(uri_, req->url_, nullptr)) {
             return false;
         }
-    } else {
-        if (uri_.ends_with("*")) {
-            // 包含特定开头
-            std::string uriTemplate = uri_.substr(0, uri_.length() - 1);
-            if (!req->url_.starts_with(uriTemplate)) {
-                return false;
-            }
-        } else {
-            // 完全匹配
-            if (uri_ != req->url_ && !req->url_.starts_with(uri_ + "/")) {
-                return false;
-            }
-        }
+        matchPath(uri_, req->url_, req);
     }
     req->addInterestingHeader("ANY");
 
     return true;
 }
 
-/// @brief 进行身份认证后执行主请求处理回调
-void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* req)
+/// @brief 正则模式以外的URI由路由树索引，正则模式由服务器逐个检测
+const std::string* AsyncCallbackWebHandler::routePattern() const
 {
-    if ((!username_.empty() && !password_.empty()) && 
-        !req->authenticate(username_.c_str(), password_.c_str())) {
-            return req->requestAuthentication();
+    if (isRegex_) {
+        return nullptr;
     }
+    return &uri_;
+}
+
+/// @brief HEAD请求由GET处理函数处理
+uint8_t AsyncCallbackWebHandler::routeMethods() const
+{
+    return (method_ & HTTP_GET) ? (method_ | HTTP_HEAD) : method_;
+}
+
+/// @brief 执行主请求处理回调（身份认证已由服务器在请求头解析完成时进行）
+void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* req)
+{
     if (onRequest_) {
         onRequest_(req);
     } else {
@@ -77,24 +129,18 @@ void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* req)
 /// @param final 是否为最后一个数据块
 void AsyncCallbackWebHandler::handleUpload(AsyncWebServerRequest* req, const std::string &filename, size_t index, uint8_t *data, size_t len, bool final)
 {
-    if ((!username_.empty() && !password_.empty()) && !req->authenticate(username_.c_str(), password_.c_str())) {
-        return req->requestAuthentication();
-    }
     if (onUpload_) {
         onUpload_(req, filename, index, data, len, final);
     }
 }
 
-/// @brief 对非上传请求体进行认证，以数据流方式传递给用户回调（适用于JSON、表单、二进制协议等）
+/// @brief 将非上传请求体以数据流方式传递给用户回调（适用于JSON、表单、二进制协议等）
 /// @param data 当前数据块指针
 /// @param len 当前数据块长度
 /// @param index 当前块在整体中的偏移
 /// @param total 整个body的长度
 void AsyncCallbackWebHandler::handleBody(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total)
 {
-    if ((!username_.empty() && !password_.empty()) && !req->authenticate(username_.c_str(), password_.c_str())) {
-        return req->requestAuthentication();
-    }
     if (onBody_) {
         onBody_(req, data, len, index, total);
     }
@@ -27,24 +27,16 @@ using ArBodyHandlerFunction = std::function<void(AsyncWebServerRequest *request,
 
 
 /// @brief 回调处理器（可用于动态文件响应）
-/*
- * URI支持：
- * 1. 正则模式
- * 2. 通配模式（扩展名匹配：以*.开头；前缀匹配：以*结尾）
- * 3. 完全匹配模式
-*/ 
+/// URI支持：
+/// 1. 正则模式（需启用CONFIG_ENABLE_REGEX，设置URI时编译，捕获组可通过pathArg()获取）
+/// 2. 通配模式（*匹配任意剩余部分，其后的字符为后缀：如"/*.js"、"/static/*"、"/img/*.png"）
+/// 3. 路径模式（匹配该路径及其子路径；参数段":name"、"{name}"匹配一个非空路径段，"{name:int}"只匹配数字，可通过pathArg()获取）
+/// 正则以外的模式由服务器的路由树索引，addHandler()之后修改URI或方法时重新索引（保持原注册顺序）
 class AsyncCallbackWebHandler : public AsyncWebHandler {
 public:
     AsyncCallbackWebHandler(){}
-    /// @brief 为处理器绑定目标URI（以^开头并且以$结尾时自动标识为正则模式）
-    void setUri(const std::string &uri) {
-        uri_ = uri;
-        isRegex_ = uri.starts_with("^") && uri.ends_with("$");
-    }
-    /// @brief 设置处理器支持的HTTP方法
-    void setMethod(WebRequestMethodComposite m) {
-        method_ = m;
-    }
+    void setUri(const std::string &uri);
+    void setMethod(WebRequestMethodComposite m);
     /// @brief 设置处理器请求主处理回调函数
     void onRequest(ArRequestHandlerFunction fn) {
         onRequest_ = fn;
@@ -62,18 +54,25 @@ public:
         return onRequest_ == nullptr;
     }
     virtual bool canHandle(AsyncWebServerRequest* req) override final;
+    virtual const std::string* routePattern() const override final;
+    virtual uint8_t routeMethods() const override final;
     virtual void handleRequest(AsyncWebServerRequest* req) override final;
     virtual void handleUpload(AsyncWebServerRequest* req, const std::string &filename, size_t index, uint8_t *data, size_t len, bool final) override final;
     virtual void handleBody(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) override final;
 
 
 protected:
+    static bool matchPath(const std::string& pattern, const std::string& url, AsyncWebServerRequest* req);
+
     std::string                 uri_{empty_string};     // 处理器绑定的URI目录
     WebRequestMethodComposite   method_{HTTP_ANY};      // 支持的HTTP方法
     ArRequestHandlerFunction    onRequest_{nullptr};    // 主请求处理回调
     ArUploadHandlerFunction     onUpload_{nullptr};     // 文件上传处理回调
     ArBodyHandlerFunction       onBody_{nullptr};       // 请求体处理回调
     bool                        isRegex_{false};        // 标识URI是否为正则模式       
+#if CONFIG_ENABLE_REGEX
+    std::regex                  regex_;                 // 编译后的正则模式
+#endif
 };
 
 #endif
\ No newline at end of file
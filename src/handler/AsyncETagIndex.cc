@@ -0,0 +1,169 @@
+#include "AsyncETagIndex.h"
+#include "AsyncStaticManifest.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "mbedtls/md5.h"
+#include "esp_log.h"
+
+#define TAG "AsyncETagIndex"
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/// @brief 获取文件的ETag（内容未变化时直接使用索引中的哈希，否则为小文件重新计算并记录于内存中）
+/// 在TCP任务中调用：不计算大文件的哈希，也不写入索引文件
+/// @param path 文件路径
+/// @param size 文件大小
+/// @param mtime 文件修改时间
+/// @return 带引号的强ETag，索引中没有且文件超过CONFIG_ETAG_INLINE_MAX_SIZE或读取失败时返回弱ETag
+std::string AsyncETagIndex::get(const std::string& path, size_t size, time_t mtime)
+{
+    if (size > CONFIG_ETAG_HASH_MAX_SIZE) {
+        return weak(size, mtime);
+    }
+    if (!loaded_) {
+        load();
+    }
+
+    auto found = records_.find(path);
+    if (found != records_.end() && found->second.size == size && found->second.mtime == (uint32_t)mtime) {
+        return format(found->second.digest);
+    }
+    if (size > CONFIG_ETAG_INLINE_MAX_SIZE) {
+        return weak(size, mtime);
+    }
+
+    Record record;
+    record.size = size;
+    record.mtime = mtime;
+    if (!hashFile(path, record.digest)) {
+        return weak(size, mtime);
+    }
+    records_[path] = record;
+    return format(record.digest);
+}
+
+/// @brief 部署时预先计算目录树中所有文件的ETag，并重写索引文件（耗时较长，应在TCP任务之外调用）
+void AsyncETagIndex::precompute(const std::string& root)
+{
+    if (!loaded_) {
+        load();
+    }
+    AsyncStaticManifest::walk(root, [this](const std::string& path, const struct stat& st) {
+        if ((size_t)st.st_size > CONFIG_ETAG_HASH_MAX_SIZE) {
+            return;
+        }
+        auto found = records_.find(path);
+        if (found != records_.end() && found->second.size == (uint32_t)st.st_size && found->second.mtime == (uint32_t)st.st_mtime) {
+            return;
+        }
+        Record record;
+        record.size = st.st_size;
+        record.mtime = st.st_mtime;
+        if (hashFile(path, record.digest)) {
+            records_[path] = record;
+        }
+    });
+    save();
+}
+
+/// @brief 弱ETag：由文件大小与修改时间生成，用于无法计算内容哈希的文件
+std::string AsyncETagIndex::weak(size_t size, time_t mtime)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "W/\"%x-%x\"", (unsigned)size, (unsigned)mtime);
+    return buf;
+}
+
+/// @brief 加载索引文件
+void AsyncETagIndex::load()
+{
+    loaded_ = true;
+    if (indexFile_.empty()) {
+        return;
+    }
+    auto* file = fopen(indexFile_.c_str(), "r");
+    if (file == nullptr) {
+        return;
+    }
+
+    std::vector<char> line(CONFIG_ETAG_PATH_MAX + 64);
+    while (fgets(line.data(), line.size(), file)) {
+        unsigned size, mtime;
+        char digest[33];
+        int offset = 0;
+        if (sscanf(line.data(), "%u %u %32s %n", &size, &mtime, digest, &offset) != 3 || strlen(digest) != 32 || offset == 0) {
+            continue;
+        }
+        std::string path(line.data() + offset);
+        if (path.empty() || path.back() != '\n') {
+            continue;
+        }
+        path.pop_back();
+        Record record;
+        record.size = size;
+        record.mtime = mtime;
+        for (int i = 0; i < 16; i++) {
+            auto hi = strchr(hex_digits, digest[i * 2]);
+            auto lo = strchr(hex_digits, digest[i * 2 + 1]);
+            record.digest[i] = ((hi ? hi - hex_digits : 0) << 4) | (lo ? lo - hex_digits : 0);
+        }
+        records_[path] = record;
+    }
+    fclose(file);
+}
+
+/// @brief 重写索引文件（包括发送时计算的项）
+void AsyncETagIndex::save()
+{
+    if (indexFile_.empty()) {
+        return;
+    }
+    auto* file = fopen(indexFile_.c_str(), "w");
+    if (file == nullptr) {
+        ESP_LOGW(TAG, "写入%s失败", indexFile_.c_str());
+        return;
+    }
+    for (const auto& item : records_) {
+        if (item.first.length() > CONFIG_ETAG_PATH_MAX || item.first.find('\n') != std::string::npos) {
+            continue;
+        }
+        auto digest = format(item.second.digest);
+        fprintf(file, "%u %u %.32s %s\n", (unsigned)item.second.size, (unsigned)item.second.mtime, digest.c_str() + 1, item.first.c_str());
+    }
+    fclose(file);
+}
+
+/// @brief 计算文件内容的MD5
+bool AsyncETagIndex::hashFile(const std::string& path, uint8_t* digest)
+{
+    auto* file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::vector<uint8_t> block(CONFIG_ETAG_HASH_BLOCK);
+    mbedtls_md5_context ctx;
+    mbedtls_md5_init(&ctx);
+    mbedtls_md5_starts(&ctx);
+    size_t len;
+    while ((len = fread(block.data(), 1, block.size(), file)) > 0) {
+        mbedtls_md5_update(&ctx, block.data(), len);
+    }
+    auto ok = !ferror(file);
+    mbedtls_md5_finish(&ctx, digest);
+    mbedtls_md5_free(&ctx);
+    fclose(file);
+    return ok;
+}
+
+/// @brief 格式化为带引号的强ETag
+std::string AsyncETagIndex::format(const uint8_t* digest)
+{
+    std::string out(34, '"');
+    for (int i = 0; i < 16; i++) {
+        out[1 + i * 2] = hex_digits[digest[i] >> 4];
+        out[2 + i * 2] = hex_digits[digest[i] & 0x0f];
+    }
+    return out;
+}
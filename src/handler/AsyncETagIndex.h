@@ -0,0 +1,46 @@
+#ifndef ASYNCETAGINDEX_H_
+#define ASYNCETAGINDEX_H_
+
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+#include <time.h>
+
+#define CONFIG_ETAG_HASH_MAX_SIZE   (1024 * 1024)   // 预先计算时，超过此大小的文件不计算内容哈希，使用弱ETag
+#define CONFIG_ETAG_INLINE_MAX_SIZE 4096            // 发送时（TCP任务中）只为不超过此大小的文件计算哈希，更大的文件在预先计算前使用弱ETag
+#define CONFIG_ETAG_HASH_BLOCK      1024            // 计算哈希时每次读取的字节数
+#define CONFIG_ETAG_PATH_MAX        256             // 索引文件中路径的最大长度（更长的路径不写入索引文件）
+
+
+/// @brief 基于内容哈希（MD5）的强ETag索引：部署时预先计算（小文件也可在首次发送时计算），保存于旁路索引文件中，重启后无需重新计算
+/// 索引文件每行一项："<大小> <修改时间> <MD5> <路径>"，只由precompute()/save()整体重写，发送时计算的项仅保存于内存中
+class AsyncETagIndex {
+public:
+    explicit AsyncETagIndex(std::string indexFile)
+        : indexFile_(std::move(indexFile))
+    {}
+
+    std::string get(const std::string& path, size_t size, time_t mtime);
+    void precompute(const std::string& root);
+    void save();
+
+    static std::string weak(size_t size, time_t mtime);
+
+private:
+    /// @brief 索引项
+    struct Record {
+        uint32_t    size;           // 计算时的文件大小
+        uint32_t    mtime;          // 计算时的修改时间
+        uint8_t     digest[16];     // 文件内容的MD5
+    };
+
+    void load();
+    static bool hashFile(const std::string& path, uint8_t* digest);
+    static std::string format(const uint8_t* digest);
+
+    std::string     indexFile_;         // 索引文件路径（为空时仅保存于内存）
+    bool            loaded_{false};     // 是否已加载索引文件
+    std::unordered_map<std::string, Record> records_;   // 以文件路径为键
+};
+
+#endif // !ASYNCETAGINDEX_H_
@@ -0,0 +1,118 @@
+#include "AsyncStaticCache.h"
+#include "../response/AsyncFileResponse.h"
+#include "my_sysInfo.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/// @brief 查找缓存项，超过校验间隔时比对文件的修改时间及大小，文件已变化时移除
+AsyncStaticCache::Entry AsyncStaticCache::get(const std::string& path)
+{
+    auto found = index_.find(path);
+    if (found == index_.end()) {
+        return nullptr;
+    }
+
+    auto it = found->second;
+    auto entry = it->second;
+    auto now = SystemInfo::GetMsSinceStart();
+    if (validateInterval_ == 0 || now - entry->checkedAt >= validateInterval_) {
+        struct stat st;
+        if (stat(entry->path.c_str(), &st) != 0 || st.st_mtime != entry->mtime || (size_t)st.st_size != entry->size) {
+            erase(it);
+            return nullptr;
+        }
+        entry->checkedAt = now;
+    }
+    lru_.splice(lru_.begin(), lru_, it);
+    return entry;
+}
+
+/// @brief 读取文件并加入缓存，文件过大或读取失败时返回nullptr
+/// @param path 将被发送的文件路径（预压缩文件含.gz/.br后缀），同时作为缓存键
+/// @param encoding 文件的内容编码（AsyncFileEncoding）
+/// @param extraHeaders 附加的响应头（已格式化）
+AsyncStaticCache::Entry AsyncStaticCache::put(const std::string& path, uint8_t encoding, const std::string& extraHeaders)
+{
+    remove(path);
+
+    auto entry = std::make_shared<AsyncStaticCacheEntry>();
+    entry->path = path;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return nullptr;
+    }
+    if (S_ISDIR(st.st_mode) || (size_t)st.st_size > maxFileSize_ || (size_t)st.st_size > budget_) {
+        return nullptr;
+    }
+
+    auto* file = fopen(entry->path.c_str(), "r");
+    if (file == nullptr) {
+        return nullptr;
+    }
+    auto body = std::make_shared<std::string>(st.st_size, '\0');
+    auto read_len = fread(&(*body)[0], 1, body->length(), file);
+    fclose(file);
+    if (read_len != body->length()) {
+        return nullptr;
+    }
+
+    // 与AsyncFileResponse一致的响应头（内容类型与文件名取自原文件名）
+    auto name = path.substr(0, path.length() - strlen(AsyncFileResponse::encodingSuffix(encoding)));
+    auto headers = std::make_shared<std::string>();
+    *headers += "Content-Disposition: inline; filename=\"";
+    *headers += name.substr(name.find_last_of('/') + 1);
+    *headers += "\"\r\n";
+    if (encoding != FILE_ENCODING_IDENTITY) {
+        *headers += "Content-Encoding: ";
+        *headers += AsyncFileResponse::encodingName(encoding);
+        *headers += "\r\n";
+    }
+    *headers += extraHeaders;
+
+    entry->contentType = AsyncFileResponse::contentTypeFor(name);
+    entry->body = std::move(body);
+    entry->headers = std::move(headers);
+    entry->mtime = st.st_mtime;
+    entry->size = st.st_size;
+    entry->checkedAt = SystemInfo::GetMsSinceStart();
+
+    used_ += cost(path, entry);
+    while (used_ > budget_ && !lru_.empty()) {
+        erase(std::prev(lru_.end()));
+    }
+    lru_.emplace_front(path, entry);
+    index_[path] = lru_.begin();
+    return entry;
+}
+
+/// @brief 移除指定文件的缓存项
+void AsyncStaticCache::remove(const std::string& path)
+{
+    auto found = index_.find(path);
+    if (found != index_.end()) {
+        erase(found->second);
+    }
+}
+
+/// @brief 清空缓存
+void AsyncStaticCache::clear()
+{
+    lru_.clear();
+    index_.clear();
+    used_ = 0;
+}
+
+/// @brief 缓存项占用的字节数（响应体仍被发送中的响应引用时，移除后内存在发送完成后释放）
+size_t AsyncStaticCache::cost(const std::string& key, const Entry& entry)
+{
+    return key.length() + entry->path.length() + entry->contentType.length()
+        + entry->body->length() + entry->headers->length() + sizeof(AsyncStaticCacheEntry);
+}
+
+void AsyncStaticCache::erase(LruList::iterator it)
+{
+    used_ -= cost(it->first, it->second);
+    index_.erase(it->first);
+    lru_.erase(it);
+}
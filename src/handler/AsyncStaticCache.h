@@ -0,0 +1,62 @@
+#ifndef ASYNCSTATICCACHE_H_
+#define ASYNCSTATICCACHE_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <time.h>
+#include "../response/AsyncWebServerResponse.h"
+
+#define CONFIG_STATIC_CACHE_BUDGET          (64 * 1024)     // 缓存总字节数上限
+#define CONFIG_STATIC_CACHE_MAX_FILE        (8 * 1024)      // 可缓存的单个文件大小上限
+#define CONFIG_STATIC_CACHE_VALIDATE_MS     2000            // 缓存项的校验间隔（毫秒），为0时每次请求都校验
+
+
+/// @brief 静态文件缓存项：文件内容及预先格式化的响应头
+struct AsyncStaticCacheEntry {
+    std::string     path;           // 实际读取的文件路径（可能为.gz/.br文件）
+    std::string     contentType;    // 内容类型
+    AwsSharedBuffer body;           // 文件内容
+    AwsSharedBuffer headers;        // 预先格式化的响应头
+    time_t          mtime;          // 文件修改时间
+    size_t          size;           // 文件大小
+    uint32_t        checkedAt;      // 上次校验的时间（毫秒）
+};
+
+
+/// @brief 小型静态文件的内存缓存：按文件路径索引（同一资源的各编码版本各为一项），总字节数超出预算时淘汰最久未使用的项
+class AsyncStaticCache {
+public:
+    using Entry = std::shared_ptr<AsyncStaticCacheEntry>;
+
+    AsyncStaticCache(size_t budget, size_t maxFileSize, uint32_t validateInterval)
+        : budget_(budget)
+        , maxFileSize_(maxFileSize)
+        , validateInterval_(validateInterval)
+    {}
+
+    Entry get(const std::string& path);
+    Entry put(const std::string& path, uint8_t encoding, const std::string& extraHeaders);
+    void remove(const std::string& path);
+    void clear();
+    /// @brief 已使用的字节数
+    size_t used() const {
+        return used_;
+    }
+
+private:
+    using LruList = std::list<std::pair<std::string, Entry>>;
+
+    static size_t cost(const std::string& key, const Entry& entry);
+    void erase(LruList::iterator it);
+
+    size_t      budget_;            // 缓存总字节数上限
+    size_t      maxFileSize_;       // 单个文件大小上限
+    uint32_t    validateInterval_;  // 校验间隔（毫秒）
+    size_t      used_{0};           // 已使用的字节数
+    LruList     lru_;               // 按最近使用排序（表头最新）
+    std::unordered_map<std::string, LruList::iterator>  index_; // 文件路径索引
+};
+
+#endif // !ASYNCSTATICCACHE_H_
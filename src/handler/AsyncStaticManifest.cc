@@ -0,0 +1,142 @@
+#include "AsyncStaticManifest.h"
+#include <algorithm>
+#include <dirent.h>
+#include <string.h>
+#include <string_view>
+#include "esp_log.h"
+
+#define TAG "AsyncStaticManifest"
+
+/// @brief FNV-1a哈希
+uint32_t AsyncStaticManifest::hash(const char* path, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)path[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/// @brief 扫描资源目录，重新生成清单
+void AsyncStaticManifest::build()
+{
+    entries_.clear();
+    paths_.clear();
+    auto rootLen = root_.length();
+    walk(root_, [this, rootLen](const std::string& path, const struct stat& st) {
+        auto* rel = path.c_str() + rootLen;
+        auto relLen = path.length() - rootLen;
+        add(rel, relLen, st.st_size, st.st_mtime, FILE_PLAIN);  // 预压缩文件也可按原名直接请求
+        if (relLen > 3 && memcmp(rel + relLen - 3, ".gz", 3) == 0) {
+            add(rel, relLen - 3, st.st_size, st.st_mtime, FILE_GZIP);
+        } else if (relLen > 3 && memcmp(rel + relLen - 3, ".br", 3) == 0) {
+            add(rel, relLen - 3, st.st_size, st.st_mtime, FILE_BROTLI);
+        }
+    });
+    auto path = [this](const Entry& entry) {
+        return std::string_view(paths_.data() + entry.offset, entry.length);
+    };
+    std::sort(entries_.begin(), entries_.end(), [&path](const Entry& a, const Entry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : path(a) < path(b);
+    });
+
+    // 原文件与预压缩文件合并为一项（各预压缩文件的大小、修改时间见其自身的清单项）
+    // 路径池按合并后的清单重新生成，去除重复的路径
+    std::vector<Entry> merged;
+    std::string paths;
+    merged.reserve(entries_.size());
+    const Entry* previous = nullptr;     // 上一项（offset仍指向原路径池）
+    for (auto& entry : entries_) {
+        bool same = previous && previous->hash == entry.hash && path(*previous) == path(entry);
+        previous = &entry;
+        if (same) {
+            auto& last = merged.back();
+            if (entry.flags & FILE_PLAIN) {
+                last.size = entry.size;
+                last.mtime = entry.mtime;
+            }
+            last.flags |= entry.flags;
+            continue;
+        }
+        merged.push_back(entry);
+        merged.back().offset = paths.length();
+        paths.append(path(entry));
+    }
+    merged.shrink_to_fit();
+    paths.shrink_to_fit();
+    entries_.swap(merged);
+    paths_.swap(paths);
+    built_ = true;
+    ESP_LOGI(TAG, "%s: %u项", root_.c_str(), (unsigned)entries_.size());
+}
+
+/// @brief 查找相对路径（以/开头）对应的清单项，首次查找时若尚未扫描则先扫描
+const AsyncStaticManifest::Entry* AsyncStaticManifest::find(const char* path, size_t len)
+{
+    if (!built_) {
+        build();
+    }
+    auto h = hash(path, len);
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), h, [](const Entry& entry, uint32_t value) {
+        return entry.hash < value;
+    });
+    for (; it != entries_.end() && it->hash == h; ++it) {
+        if (it->length == len && memcmp(paths_.data() + it->offset, path, len) == 0) {
+            return &(*it);
+        }
+    }
+    return nullptr;
+}
+
+/// @brief 遍历目录树中的所有文件
+/// @param root 根目录（不以/结尾）
+/// @param visitor 对每个文件调用
+void AsyncStaticManifest::walk(const std::string& root, const FileVisitor& visitor)
+{
+    std::string dir = root;
+    walk(dir, visitor, 0);
+}
+
+/// @brief 递归遍历目录
+/// @param dir 当前目录（遍历过程中作为路径缓冲区复用）
+void AsyncStaticManifest::walk(std::string& dir, const FileVisitor& visitor, uint8_t depth)
+{
+    auto* handle = opendir(dir.empty() ? "/" : dir.c_str());
+    if (handle == nullptr) {
+        return;
+    }
+
+    auto dirLen = dir.length();
+    struct dirent* item;
+    while ((item = readdir(handle)) != nullptr) {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) {
+            continue;
+        }
+        dir.push_back('/');
+        dir += item->d_name;
+
+        struct stat st;
+        if (stat(dir.c_str(), &st) == 0) {
+            if (S_ISDIR(st.st_mode)) {
+                if (depth + 1 < CONFIG_STATIC_MANIFEST_DEPTH) {
+                    walk(dir, visitor, depth + 1);
+                }
+            } else {
+                visitor(dir, st);
+            }
+        }
+        dir.resize(dirLen);
+    }
+    closedir(handle);
+}
+
+/// @brief 添加清单项（路径长度超出uint16_t时忽略，请求时按文件不存在处理）
+void AsyncStaticManifest::add(const char* path, size_t len, uint32_t size, uint32_t mtime, uint8_t flags)
+{
+    if (len > UINT16_MAX) {
+        return;
+    }
+    entries_.push_back({hash(path, len), (uint32_t)paths_.length(), size, mtime, (uint16_t)len, flags});
+    paths_.append(path, len);
+}
@@ -0,0 +1,63 @@
+#ifndef ASYNCSTATICMANIFEST_H_
+#define ASYNCSTATICMANIFEST_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <time.h>
+
+#define CONFIG_STATIC_MANIFEST_DEPTH    8   // 扫描目录的最大深度
+
+
+/// @brief 静态资源清单：启动时扫描一次资源目录，按路径哈希排序，请求时二分查找并比较路径代替stat()
+class AsyncStaticManifest {
+public:
+    /// @brief 与可用编码位图（1 << AsyncFileEncoding）一致
+    enum : uint8_t {
+        FILE_PLAIN  = 0x01,     // 存在原文件
+        FILE_GZIP   = 0x02,     // 存在.gz文件
+        FILE_BROTLI = 0x04,     // 存在.br文件
+    };
+
+    /// @brief 清单项（路径连续保存于清单的路径池中，哈希相同时以路径区分）
+    struct Entry {
+        uint32_t    hash;       // 相对路径（不含.gz后缀）的哈希
+        uint32_t    offset;     // 相对路径在路径池中的位置
+        uint32_t    size;       // 文件大小（存在原文件时为原文件，否则为某个预压缩文件）
+        uint32_t    mtime;      // 文件修改时间
+        uint16_t    length;     // 相对路径的长度
+        uint8_t     flags;      // FILE_PLAIN | FILE_GZIP | FILE_BROTLI
+    };
+
+    explicit AsyncStaticManifest(std::string root)
+        : root_(std::move(root))
+    {}
+
+    void build();
+    const Entry* find(const char* path, size_t len);
+    /// @brief 是否已扫描
+    bool built() const {
+        return built_;
+    }
+    size_t size() const {
+        return entries_.size();
+    }
+
+    static uint32_t hash(const char* path, size_t len);
+
+    using FileVisitor = std::function<void(const std::string& path, const struct stat& st)>;
+    static void walk(const std::string& root, const FileVisitor& visitor);
+
+private:
+    static void walk(std::string& dir, const FileVisitor& visitor, uint8_t depth);
+    void add(const char* path, size_t len, uint32_t size, uint32_t mtime, uint8_t flags);
+
+    std::string         root_;          // 资源目录（不以/结尾）
+    std::vector<Entry>  entries_;       // 按hash（相同时按路径）排序的清单
+    std::string         paths_;         // 路径池（各清单项的相对路径首尾相接）
+    bool                built_{false};  // 是否已扫描
+};
+
+#endif // !ASYNCSTATICMANIFEST_H_
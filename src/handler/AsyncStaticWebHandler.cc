@@ -2,6 +2,9 @@
 #include "../request/AsyncWebServerRequest.h"
 #include "../response/AsyncBasicResponse.h"
 #include "../response/AsyncFileResponse.h"
+#include "../header/DateHeader.h"
+#include "../router/AsyncMountTable.h"
+#include "my_sysInfo.h"
 #include <string.h>
 
 #define TAG "AsyncStaticWebHandler"
@@ -14,7 +17,7 @@
 /// @param cache_control 缓存控制行为
 /// new AsyncStaticWebHandler("/", "/spiffs/", "public, max-age=31536000");
 AsyncStaticWebHandler::AsyncStaticWebHandler(const char* uri, const char* path, const char* cache_control)
-    : cache_control_(cache_control)
+    : cache_control_(cache_control ? cache_control : "")
 {
     auto uri_len = strlen(uri);
     uri_.reserve(uri_len + 1);
@@ -56,64 +59,226 @@ AsyncStaticWebHandler::AsyncStaticWebHandler(const char* uri, const char* path,
 /// @param req 请求
 bool AsyncStaticWebHandler::canHandle(AsyncWebServerRequest* req)
 {
-    if ((req->method_ != HTTP_GET) 
-            || !req->url_.starts_with(uri_)
+    if (!mayHandle(req->url_, req->method_)
             || !req->isExpectedRequestedConnType(RCT_DEFAULT, RCT_HTTP)) {
         return false;
     }
 
     if (getFile(req)) {
-        if (last_modified_.length()) {
-            req->addInterestingHeader("If-Modified-Since");
-        }
-        if (cache_control_.length()) {
-            req->addInterestingHeader("If-None-Match");
-        }
+        req->addInterestingHeader("Accept-Encoding");
+        req->addInterestingHeader("If-None-Match");
+        req->addInterestingHeader("If-Modified-Since");
+        req->addInterestingHeader("If-Unmodified-Since");
+        req->addInterestingHeader("Range");
+        req->addInterestingHeader("If-Range");
         return true;
     }
 
     return false;
 }
 
+/// @brief 只可能处理根路径下的GET/HEAD请求
+bool AsyncStaticWebHandler::mayHandle(const std::string& url, uint8_t method) const
+{
+    return (method & (HTTP_GET | HTTP_HEAD)) && AsyncMountTable::covers(uri_, url);
+}
 
 void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest* req)
 {
-    if (username_.length() && password_.length() 
-        && req->authenticate(username_.c_str(), password_.c_str())) {
-            req->requestAuthentication();
+    if (!req->fileName_) {
+        getFile(req);
     }
 
-    struct stat file_stat;
-    if (stat(req->fileName_, &file_stat) != -1) {
-        auto etag = std::to_string(file_stat.st_size);
-        if (last_modified_.length() && last_modified_ == req->header("If-Modified-Since")) {
-            req->send(304);
-        } else if (cache_control_.length() && req->hasHeader("If-None-Match") 
-            && (req->header("If-None-Match") == etag)) {
-                auto* response = new AsyncBasicResponse(304);
-                response->addHeader("Cache-Control", cache_control_);
-                response->addHeader("ETag", etag);
-                req->send(response);
-        } else {
-            auto* response = new AsyncFileResponse(req->fileName_, "", false, callback_);
-            if (last_modified_.length()) {
-                response->addHeader("Last-Modified", last_modified_);
+    // 按Accept-Encoding确定将被发送的文件（原文件或预压缩文件）及其大小、修改时间
+    bool found = false;
+    uint8_t available = 0;
+    AsyncFileInfo info{0, 0, FILE_ENCODING_IDENTITY};
+    AsyncStaticCache::Entry entry;
+    std::string served;
+    if (req->fileName_) {
+        available = variants(req->fileName_);
+        auto* accept = req->hasHeader("Accept-Encoding") ? req->header("Accept-Encoding").c_str() : nullptr;
+        auto encoding = AsyncFileResponse::negotiateEncoding(accept, available);
+        if (encoding >= 0) {
+            info.encoding = encoding;
+            served = req->fileName_;
+            served += AsyncFileResponse::encodingSuffix(encoding);
+            // 范围请求由文件响应处理，不使用缓存
+            entry = (cache_ && !req->hasHeader("Range")) ? cache_->get(served) : nullptr;
+            if (entry) {
+                found = true;
+                info.size = entry->size;
+                info.mtime = entry->mtime;
+            } else if (manifest_) {
+                auto* item = findInManifest(served.c_str());
+                if (item && (item->flags & AsyncStaticManifest::FILE_PLAIN)) {
+                    found = true;
+                    info.size = item->size;
+                    info.mtime = item->mtime;
+                }
+            } else {
+                struct stat file_stat;
+                if (stat(served.c_str(), &file_stat) != -1) {
+                    found = true;
+                    info.size = file_stat.st_size;
+                    info.mtime = file_stat.st_mtime;
+                } else {
+                    variants_.erase(req->fileName_);    // 文件已被删除
+                }
             }
+        }
+    }
+    // 存在预压缩文件时，响应随Accept-Encoding而不同
+    bool vary = available & ~(1 << FILE_ENCODING_IDENTITY);
+
+    if (found) {
+        // 经模板处理的内容每次都可能不同，不使用实体标签，也不以文件修改时间作为Last-Modified
+        bool templated = callback_ || writer_;
+        auto etag = templated ? empty_string : etagFor(served, info.size, info.mtime);
+        char dateBuf[HTTP_DATE_LENGTH + 1];
+        std::string lastModified = last_modified_;
+        if (lastModified.empty() && !templated && info.mtime >= CONFIG_DATE_VALID_AFTER) {
+            lastModified.assign(dateBuf, formatHttpDate(info.mtime, dateBuf));
+        }
+        auto modifiedAt = lastModified.empty() ? (time_t)-1 : parseHttpDate(lastModified.c_str());
+
+        // 条件请求按RFC 7232第6节的顺序求值；If-Unmodified-Since的日期无法解析时忽略该头（第3.4节）
+        auto unmodifiedSince = (modifiedAt != -1 && req->hasHeader("If-Unmodified-Since"))
+            ? parseHttpDate(req->header("If-Unmodified-Since").c_str()) : (time_t)-1;
+        if (unmodifiedSince != -1 && modifiedAt > unmodifiedSince) {
+                req->send(412);
+        } else if (notModified(req, etag, modifiedAt)) {
+            auto* response = new AsyncBasicResponse(304);
             if (cache_control_.length()) {
                 response->addHeader("Cache-Control", cache_control_);
+            }
+            if (vary) {
+                response->addHeader("Vary", "Accept-Encoding");
+            }
+            if (etag.length()) {
                 response->addHeader("ETag", etag);
             }
             req->send(response);
+        } else {
+            if (!entry && cache_ && !templated && !req->hasHeader("Range")) {
+                entry = cache_->put(served, info.encoding, cacheHeaders(etag, lastModified, vary));
+            }
+            if (entry) {
+                // 缓存的文件内容与响应头由各响应共享，免拷贝发送
+                auto* response = new AsyncBasicResponse(200, entry->contentType, entry->body);
+                response->addRawHeaders(entry->headers);
+                req->send(response);
+            } else {
+                auto* response = new AsyncFileResponse(req->fileName_, info, "", callback_);
+                if (writer_) {
+                    response->setTemplateWriter(writer_);
+                }
+                if (lastModified.length()) {
+                    response->addHeader("Last-Modified", lastModified);
+                }
+                if (cache_control_.length()) {
+                    response->addHeader("Cache-Control", cache_control_);
+                }
+                if (vary) {
+                    response->addHeader("Vary", "Accept-Encoding");
+                }
+                if (!templated) {
+                    response->addHeader("ETag", etag);
+                }
+                req->send(response);
+            }
         }
+    } else if (available && served.empty()) {
+        // 只有客户端不接受的预压缩文件
+        auto* response = new AsyncBasicResponse(406);
+        response->addHeader("Vary", "Accept-Encoding");
+        req->send(response);
     } else {
         req->send(404);
     }
 
     auto* tmp = req->fileName_;
     req->fileName_ = nullptr;
-    delete tmp;
+    delete[] tmp;
+}
+
+
+/// @brief 启用小文件内存缓存：重复请求直接由内存响应，不访问文件系统（经模板处理的文件不缓存）
+/// @param budget 缓存总字节数上限
+/// @param maxFileSize 可缓存的单个文件大小上限
+/// @param validateInterval 校验文件是否变化的间隔（毫秒）
+AsyncStaticWebHandler& AsyncStaticWebHandler::setCache(size_t budget, size_t maxFileSize, uint32_t validateInterval)
+{
+    if (budget == 0) {
+        cache_.reset();
+    } else {
+        cache_.reset(new AsyncStaticCache(budget, maxFileSize, validateInterval));
+    }
+    return *this;
 }
 
+/// @brief 启用基于内容哈希的强ETag（未启用时使用由大小与修改时间生成的弱ETag）
+/// @param indexFile 保存哈希的旁路索引文件（应位于资源目录之外），为空时仅保存于内存
+AsyncStaticWebHandler& AsyncStaticWebHandler::setETagIndex(const char* indexFile)
+{
+    etags_.reset(new AsyncETagIndex(indexFile ? indexFile : ""));
+    return *this;
+}
+
+/// @brief 部署新资源后预先计算所有文件的ETag并写入索引文件（超过CONFIG_ETAG_INLINE_MAX_SIZE的文件在此之前使用弱ETag），应在TCP任务之外调用
+void AsyncStaticWebHandler::precomputeETags()
+{
+    if (etags_) {
+        etags_->precompute(path_);
+    }
+}
+
+/// @brief 获取将被发送的文件的实体标签
+std::string AsyncStaticWebHandler::etagFor(const std::string& path, size_t size, time_t mtime)
+{
+    if (etags_) {
+        return etags_->get(path, size, mtime);
+    }
+    return AsyncETagIndex::weak(size, mtime);
+}
+
+/// @brief 检查缓存的副本是否仍然有效（If-None-Match存在时忽略If-Modified-Since）
+/// @param etag 当前资源的实体标签（为空表示无）
+/// @param modifiedAt 当前资源的修改时间（-1表示未知）
+bool AsyncStaticWebHandler::notModified(AsyncWebServerRequest* req, const std::string& etag, time_t modifiedAt) const
+{
+    if (req->hasHeader("If-None-Match")) {
+        return etagMatches(req->header("If-None-Match").c_str(), etag);
+    }
+    if (modifiedAt != -1 && req->hasHeader("If-Modified-Since")) {
+        auto since = parseHttpDate(req->header("If-Modified-Since").c_str());
+        return since != -1 && modifiedAt <= since;
+    }
+    return false;
+}
+
+/// @brief 组装缓存项中由处理器决定的响应头
+std::string AsyncStaticWebHandler::cacheHeaders(const std::string& etag, const std::string& lastModified, bool vary) const
+{
+    std::string out;
+    if (lastModified.length()) {
+        out += "Last-Modified: ";
+        out += lastModified;
+        out += "\r\n";
+    }
+    if (cache_control_.length()) {
+        out += "Cache-Control: ";
+        out += cache_control_;
+        out += "\r\n";
+    }
+    if (vary) {
+        out += "Vary: Accept-Encoding\r\n";
+    }
+    out += "ETag: ";
+    out += etag;
+    out += "\r\n";
+    return out;
+}
 
 /// @brief 检查req中的文件是否存在，存在时将存于req->tmpObj中
 bool AsyncStaticWebHandler::getFile(AsyncWebServerRequest* req)
@@ -153,65 +318,95 @@ bool AsyncStaticWebHandler::getFile(AsyncWebServerRequest* req)
     return fileExists(req, fullPath);
 }
 
-/// @brief 检查指定路径的文件是否存在（存在时文件路径存在于req->tmpObj_），并根据请求次数设置优先发送gzip文件标志
+/// @brief 检查指定路径的文件（或其预压缩文件）是否存在，存在时文件路径存于req->fileName_
 bool AsyncStaticWebHandler::fileExists(AsyncWebServerRequest* req, const std::string& path)
 {
-    auto fileFound = false;
-    auto gzipFound = false;
-    auto gzip = path + ".gz";
+    if (!variants(path)) {
+        return false;
+    }
+    auto pathLen = path.length() + 1;
+    if (req->fileName_) delete[] req->fileName_;
+    req->fileName_ = new char[pathLen];
+    snprintf(req->fileName_, pathLen, "%s", path.c_str());
+    return true;
+}
 
-    if (gzipFirst_) {
-        gzipFound = FILE_IS_REAL(gzip.c_str());
-        if (!gzipFound) {
-            fileFound = FILE_IS_REAL(path.c_str());
+/// @brief 获取文件的可用编码（原文件、.gz、.br）：启用清单时查找清单，否则查找可用编码缓存，未缓存时访问文件系统
+/// 不存在的文件在CONFIG_STATIC_MISSING_CACHE_MS内不再访问文件系统（反复请求不存在的URL时不产生flash读取）；
+/// 已存在文件的新增预压缩版本须refresh()后生效
+/// @return 可用编码的位图（1 << AsyncFileEncoding），0表示文件不存在
+uint8_t AsyncStaticWebHandler::variants(const std::string& path)
+{
+    if (manifest_) {
+        auto* item = findInManifest(path.c_str());
+        return item ? item->flags : 0;
+    }
+    auto found = variants_.find(path);
+    if (found != variants_.end()) {
+        return found->second;
+    }
+    auto now = SystemInfo::GetMsSinceStart();
+    auto missing = missing_.find(path);
+    if (missing != missing_.end()) {
+        if ((uint32_t)(now - missing->second) < CONFIG_STATIC_MISSING_CACHE_MS) {
+            return 0;
         }
-    } else {
-        fileFound = FILE_IS_REAL(path.c_str());
-        if (!fileFound) {
-            gzipFound = FILE_IS_REAL(gzip.c_str());
+        missing_.erase(missing);
+    }
+    auto available = AsyncFileResponse::availableEncodings(path);
+    if (available) {
+        if (variants_.size() >= CONFIG_STATIC_VARIANT_CACHE_SIZE) {
+            variants_.clear();
+        }
+        variants_.emplace(path, available);
+    } else if (CONFIG_STATIC_MISSING_CACHE_SIZE > 0) {
+        if (missing_.size() >= CONFIG_STATIC_MISSING_CACHE_SIZE) {
+            missing_.clear();
         }
+        missing_.emplace(path, now);
     }
-    bool found = fileFound || gzipFound;
+    return available;
+}
 
-    if (found) {
-        auto pathLen = path.length() + 1;
-        if (req->fileName_) delete req->fileName_;
-        req->fileName_ = new char[pathLen];
-        snprintf(req->fileName_, pathLen, "%s", path.c_str());
-
-        gzipStats_ = (gzipStats_ << 1) + (gzipFound ? 1 : 0);
-        if (gzipStats_ == 0x00) {
-            gzipFirst_ = false;
-        } else if (gzipStats_ == 0xff) {
-            gzipFirst_ = true;
-        } else {
-            gzipFirst_ = countBits(gzipStats_) > 4;
-        }
+/// @brief 在清单中查找文件系统路径（须位于资源目录下）
+const AsyncStaticManifest::Entry* AsyncStaticWebHandler::findInManifest(const char* path) const
+{
+    auto len = strlen(path);
+    if (len <= path_.length()) {
+        return nullptr;
     }
-    return found;
+    return manifest_->find(path + path_.length(), len - path_.length());
 }
 
-/// @brief 计算给定数据的二进制中1所占的个数
-inline uint8_t AsyncStaticWebHandler::countBits(const uint8_t value) const
+/// @brief 启用静态资源清单：在服务器启动时扫描一次资源目录，请求时查找清单而不访问文件系统元数据
+/// 资源目录中的文件变化后须调用refresh()
+AsyncStaticWebHandler& AsyncStaticWebHandler::setManifest(bool enable)
 {
-    uint8_t w = value;
-    uint8_t i;
-    for (i = 0; w != 0; i++) {
-        w &= w - 1;
+    if (!enable) {
+        manifest_.reset();
+    } else if (!manifest_) {
+        manifest_.reset(new AsyncStaticManifest(path_));
     }
+    return *this;
+}
 
-    return i;
+/// @brief 服务器启动时扫描资源目录
+void AsyncStaticWebHandler::begin()
+{
+    if (manifest_ && !manifest_->built()) {
+        manifest_->build();
+    }
 }
 
-/// @brief 检查文件系统中是否存在指定的的文件
-bool AsyncStaticWebHandler::FILE_IS_REAL(const char* path) const
+/// @brief 资源更新后重新扫描资源目录，并清空内存缓存
+void AsyncStaticWebHandler::refresh()
 {
-    struct stat path_stat;
-    if (stat(path, &path_stat) == -1) {
-        return false;
+    if (manifest_) {
+        manifest_->build();
     }
-    if (S_ISDIR(path_stat.st_mode)) {
-        return false;
+    variants_.clear();
+    missing_.clear();
+    if (cache_) {
+        cache_->clear();
     }
-    return true;
-}
\ No newline at end of file
+}
@@ -2,11 +2,21 @@
 #define ASYNCSTATICWEBHANDLER_H_
 
 #include "AsyncWebHandler.h"
+#include "AsyncStaticCache.h"
+#include "AsyncStaticManifest.h"
+#include "AsyncETagIndex.h"
 #include <string>
+#include <memory>
+#include <unordered_map>
 #include "time.h"
 #include "../tools.h"
 
 
+#define CONFIG_STATIC_VARIANT_CACHE_SIZE    64  // 未启用清单时缓存可用编码的文件数上限（超出时清空）
+#define CONFIG_STATIC_MISSING_CACHE_SIZE    64  // 未启用清单时缓存不存在的文件路径数上限（超出时清空，为0时不缓存）
+#define CONFIG_STATIC_MISSING_CACHE_MS      5000    // 不存在的文件路径的缓存时长（毫秒），期间新增的文件须等缓存过期或refresh()后才能找到
+
+
 class AsyncWebServer;
 class AsyncWebServerRequest;
 class AsyncWebServerResponse;
@@ -20,6 +30,8 @@ class AsyncResponseStream;
 
 
 using AwsTemplateProcessor = std::function<std::string(const std::string& )>;
+class AsyncTemplateWriter;
+using AwsTemplateWriter = std::function<void(const std::string& name, AsyncTemplateWriter& out)>;
 
 
 /*
@@ -34,7 +46,16 @@ class AsyncStaticWebHandler : public AsyncWebHandler {
 public:
     AsyncStaticWebHandler(const char* uri, const char* path, const char* cache_control);
     virtual bool canHandle(AsyncWebServerRequest* req) override final;
+    virtual bool mayHandle(const std::string& url, uint8_t method) const override final;
+    virtual const std::string* mountPoint() const override final {
+        return &uri_;
+    }
     virtual void handleRequest(AsyncWebServerRequest* req) override final;
+    virtual void begin() override;
+    AsyncStaticWebHandler& setManifest(bool enable = true);
+    void refresh();
+    AsyncStaticWebHandler& setETagIndex(const char* indexFile = nullptr);
+    void precomputeETags();
     /// @brief 标记当前URI为目录
     inline AsyncStaticWebHandler& setIsDir(bool isDir) {
         isDir_ = isDir;
@@ -47,11 +68,17 @@ public:
     }
     inline AsyncStaticWebHandler& setCacheControl(const char* cache_control) {
         cache_control_ = cache_control;
+        if (cache_) {
+            cache_->clear();    // 缓存项中的响应头已过时
+        }
         return *this;
     }
-    /// @brief 设置资源 Last-Modified 的数值（上次修改时间）
+    /// @brief 设置资源 Last-Modified 的数值（上次修改时间），未设置时使用各文件的修改时间
     inline AsyncStaticWebHandler& setLastModified(const char* last_modified) {
         last_modified_ = last_modified;
+        if (cache_) {
+            cache_->clear();
+        }
         return *this;
     }
     /// @brief 设置资源 Last-Modified 的数值（上次修改时间）
@@ -60,11 +87,19 @@ public:
         strftime(result, 30, "%a, %d %b %Y %H:%M:%S %Z", last_modified);
         return setLastModified((const char*)result);
     }
+    AsyncStaticWebHandler& setCache(size_t budget = CONFIG_STATIC_CACHE_BUDGET,
+                                    size_t maxFileSize = CONFIG_STATIC_CACHE_MAX_FILE,
+                                    uint32_t validateInterval = CONFIG_STATIC_CACHE_VALIDATE_MS);
     /// @brief 设置当前URI的模板处理函数
     inline AsyncStaticWebHandler& setTemplateProcessor(AwsTemplateProcessor cb) {
         callback_ = cb;
         return *this;
     }
+    /// @brief 设置当前URI的模板输出函数（占位符的值直接写入输出，优先于模板处理函数）
+    inline AsyncStaticWebHandler& setTemplateWriter(AwsTemplateWriter writer) {
+        writer_ = writer;
+        return *this;
+    }
 protected:
     std::string     uri_;                           // 处理器绑定的根路径URI目录(已去除末尾的/)
     std::string     path_;                          // 文件系统中的资源目录(已去除末尾的/)
@@ -72,14 +107,21 @@ protected:
     std::string     cache_control_;                 // 缓存控制头（如max-age=3600}
     std::string     last_modified_{empty_string};   // 最后修改时间
     bool            isDir_{false};                  // 标记处理的URI是否为目录
-    bool            gzipFirst_{false};              // 是否优先查找gzip文件
-    uint8_t         gzipStats_{0xF8};               // GZIP查找统计（8位位图）
     AwsTemplateProcessor    callback_{nullptr};     //
+    AwsTemplateWriter       writer_{nullptr};       // 模板输出函数
+    std::unique_ptr<AsyncStaticCache>   cache_;     // 小文件内存缓存（为空表示未启用）
+    std::unique_ptr<AsyncStaticManifest> manifest_; // 静态资源清单（为空表示未启用）
+    std::unique_ptr<AsyncETagIndex>     etags_;     // 内容哈希ETag索引（为空时使用弱ETag）
+    std::unordered_map<std::string, uint8_t>    variants_;  // 文件路径 -> 可用编码位图（未启用清单时）
+    std::unordered_map<std::string, uint32_t>   missing_;   // 不存在的文件路径 -> 确认时间（毫秒，未启用清单时）
 private:
     bool    getFile(AsyncWebServerRequest* req);
+    bool    notModified(AsyncWebServerRequest* req, const std::string& etag, time_t modifiedAt) const;
+    std::string cacheHeaders(const std::string& etag, const std::string& lastModified, bool vary) const;
+    std::string etagFor(const std::string& path, size_t size, time_t mtime);
     bool    fileExists(AsyncWebServerRequest* req, const std::string& path);
-    inline uint8_t countBits(const uint8_t value) const;
-    bool    FILE_IS_REAL(const char* path) const;
+    uint8_t variants(const std::string& path);
+    const AsyncStaticManifest::Entry* findInManifest(const char* path) const;
 };
 
 #endif  
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include <functional>
 #include <string>
+#include <stdint.h>
+#include "../middleware/AsyncMiddleware.h"
 
 
 
@@ -23,25 +25,60 @@ using ArRequestFilterFunction = std::function<bool(AsyncWebServerRequest* req)>;
 class AsyncWebHandler {
 public:
     AsyncWebHandler(){}
-    virtual ~AsyncWebHandler(){}
+    virtual ~AsyncWebHandler() {
+        delete middleware_;
+    }
+    AsyncWebHandler(const AsyncWebHandler&) = delete;
+    AsyncWebHandler& operator=(const AsyncWebHandler&) = delete;
 
     AsyncWebHandler& setFilter(ArRequestFilterFunction fn) {
         filter_ = fn;
         return *this;
     }
+    /// @brief 设置认证信息（请求头解析完成时由服务器检查一次，失败时应答401，不再调用处理器）
     AsyncWebHandler& setAuthentication(const char* name, const char* passwd) {
         username_ = name;
         password_ = passwd;
         return *this;
     }
+    /// @brief 设置处理器的中间件链（由middleware()创建，处理器接管其内存，再次调用时替换之前的链）
+    /// 中间件在路由确定之后执行，不影响处理器的选择，也不妨碍路由结果的缓存
+    AsyncWebHandler& use(AsyncMiddleware* middleware) {
+        delete middleware_;
+        middleware_ = middleware;
+        return *this;
+    }
+    AsyncMiddleware* middleware() const {
+        return middleware_;
+    }
+    /// @brief 是否需要认证
+    bool hasAuthentication() const {
+        return !username_.empty() && !password_.empty();
+    }
     /// @brief 是否通过过滤器检测
     bool filter(AsyncWebServerRequest* req) {
         return filter_ == nullptr || filter_(req);
     }
+    /// @brief 是否设置了过滤器（过滤结果可能取决于请求状态，路由结果不缓存）
+    bool hasFilter() const {
+        return filter_ != nullptr;
+    }
     virtual bool isRequestHandlerTrivial() {
         return true;
     }
+    /// @brief 服务器启动时调用，可在此完成一次性的准备工作
+    virtual void begin() {}
     virtual bool canHandle(AsyncWebServerRequest* req [[maybe_unused]]) { return false; }
+    /// @brief 仅按URL与方法判断处理器是否可能处理请求（不得有副作用）
+    /// 返回false时服务器不再调用filter()与canHandle()，且该处理器不影响路由结果的缓存
+    virtual bool mayHandle(const std::string& url [[maybe_unused]], uint8_t method [[maybe_unused]]) const { return true; }
+    /// @brief 静态资源类处理器返回其挂载的URI前缀，服务器按最长前缀为每个URL只选出一个挂载点检测
+    virtual const std::string* mountPoint() const { return nullptr; }
+    /// @brief 可由路由树索引的处理器返回其URI模式，否则返回nullptr（由服务器按注册顺序调用canHandle检测）
+    /// @note 路由在addHandler()时建立；此后URI或方法改变时，派生类须调用reindex()
+    virtual const std::string* routePattern() const { return nullptr; }
+    /// @brief 路由支持的HTTP方法
+    virtual uint8_t routeMethods() const { return 0xff; }
     virtual void handleRequest(AsyncWebServerRequest* req [[maybe_unused]]) {}
     virtual void handleUpload(AsyncWebServerRequest *request  [[maybe_unused]],
                               const std::string &filename [[maybe_unused]],
@@ -56,9 +93,16 @@ public:
                             size_t total [[maybe_unused]]){}
 
 protected:
+    friend class AsyncWebServer;
+
+    void reindex();
+
     std::string             username_{};
     std::string             password_{};
     ArRequestFilterFunction filter_;
+    AsyncMiddleware*        middleware_{nullptr};   // 中间件链
+    AsyncWebServer*         server_{nullptr};       // 所属服务器（addHandler()时设置）
+    uint32_t                order_{0};              // 在所属服务器中的注册序号
 };
 
 #endif // !ASYNCWEBHANDLER_H_
\ No newline at end of file
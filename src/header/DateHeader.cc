@@ -0,0 +1,77 @@
+#include "DateHeader.h"
+#include "../tools.h"
+#include "esp_log.h"
+
+#define TAG "DateHeader"
+
+DateHeader& DateHeader::Instance()
+{
+    static DateHeader instance;
+    return instance;
+}
+
+DateHeader::~DateHeader()
+{
+    stop();
+}
+
+/// @brief 启动每秒刷新定时器（重复调用无副作用）
+void DateHeader::start()
+{
+    if (timer_ != nullptr) {
+        return;
+    }
+
+    esp_timer_create_args_t args = {};
+    args.callback = [](void* arg) {
+        reinterpret_cast<DateHeader*>(arg)->refresh();
+    };
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "http_date";
+    args.skip_unhandled_events = true;
+
+    esp_timer_handle_t timer = nullptr;
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        ESP_LOGE(TAG, "创建Date刷新定时器失败");
+        return;
+    }
+    refresh();  // 先生成一次，保证启用后首个响应即可携带
+    if (esp_timer_start_periodic(timer, 1000 * 1000) != ESP_OK) {
+        ESP_LOGE(TAG, "启动Date刷新定时器失败");
+        esp_timer_delete(timer);
+        return;
+    }
+    timer_ = timer;
+}
+
+/// @brief 停止刷新，此后响应不再携带Date头
+/// 先停止并删除定时器再清除当前值，避免已触发的刷新在清除之后重新写入有效日期
+void DateHeader::stop()
+{
+    auto* timer = timer_;
+    timer_ = nullptr;
+    if (timer) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+    }
+    current_.store(-1, std::memory_order_release);
+}
+
+/// @brief 重新格式化日期（同一秒内重复调用直接返回）
+void DateHeader::refresh()
+{
+    auto now = time(nullptr);
+    if (now < CONFIG_DATE_VALID_AFTER) {
+        current_.store(-1, std::memory_order_release);
+        return;
+    }
+    if (now == lastSecond_ && current_.load(std::memory_order_relaxed) >= 0) {
+        return;
+    }
+
+    int8_t next = current_.load(std::memory_order_relaxed) == 0 ? 1 : 0;
+    formatHttpDate(now, buffer_[next]);
+    lastSecond_ = now;
+    current_.store(next, std::memory_order_release);
+}
@@ -0,0 +1,42 @@
+#ifndef DATEHEADER_H_
+#define DATEHEADER_H_
+
+#include <atomic>
+#include <time.h>
+#include "esp_timer.h"
+
+#define HTTP_DATE_LENGTH            29          // IMF-fixdate固定长度，如"Sun, 06 Nov 1994 08:49:37 GMT"
+#define CONFIG_DATE_VALID_AFTER     1577836800  // 早于2020-01-01视为时钟未同步（RFC 7231：无可靠时钟时不得发送Date）
+
+/// @brief 服务器级缓存的Date响应头：由定时器每秒重新格式化一次，组装响应头时只做拼接
+class DateHeader {
+public:
+    static DateHeader& Instance();
+
+    DateHeader(const DateHeader &) = delete;            // 删除拷贝构造
+    DateHeader& operator=(const DateHeader &) = delete; // 删除拷贝复值
+
+    void start();
+    void stop();
+    void refresh();
+    /// @brief 是否已启用Date响应头
+    bool enabled() const {
+        return timer_ != nullptr;
+    }
+    /// @brief 获取缓存的日期字符串（未启用或时钟未同步时返回nullptr），长度固定为HTTP_DATE_LENGTH
+    const char* value() const {
+        auto index = current_.load(std::memory_order_acquire);
+        return index < 0 ? nullptr : buffer_[index];
+    }
+
+private:
+    DateHeader() {}
+    ~DateHeader();
+
+    char                buffer_[2][HTTP_DATE_LENGTH + 1];   // 双缓冲：刷新时写入非当前缓冲区
+    std::atomic<int8_t> current_{-1};                       // 当前可读缓冲区索引（-1表示无效）
+    time_t              lastSecond_{0};                     // 最近一次格式化的时间（秒）
+    esp_timer_handle_t  timer_{nullptr};                    // 每秒刷新定时器
+};
+
+#endif // !DATEHEADER_H_
@@ -0,0 +1,40 @@
+#include "AsyncMiddleware.h"
+#include "../request/AsyncWebServerRequest.h"
+#include "../response/AsyncWebServerResponse.h"
+
+#define TAG "AsyncMiddleware"
+
+/// @param origin 允许的来源（Access-Control-Allow-Origin）
+/// @param methods 允许的方法（Access-Control-Allow-Methods）
+/// @param headers 允许的请求头（Access-Control-Allow-Headers）
+/// @param maxAge 预检结果的缓存时间（Access-Control-Max-Age，秒）
+AsyncCorsMiddleware::AsyncCorsMiddleware(const char* origin, const char* methods, const char* headers, uint32_t maxAge)
+    : origin_(origin ? origin : "*")
+    , methods_(methods ? methods : "")
+    , headers_(headers ? headers : "")
+    , maxAge_(std::to_string(maxAge))
+{
+}
+
+/// @brief 预检请求（带Access-Control-Request-Method的OPTIONS请求）直接以204应答，不再交给处理器
+bool AsyncCorsMiddleware::before(AsyncWebServerRequest* req)
+{
+    if (req->method() != HTTP_OPTIONS || !req->hasHeader("Access-Control-Request-Method")) {
+        return true;
+    }
+    auto* response = req->beginResponse(204);
+    if (!methods_.empty()) {
+        response->addHeader("Access-Control-Allow-Methods", methods_);
+    }
+    if (!headers_.empty()) {
+        response->addHeader("Access-Control-Allow-Headers", headers_);
+    }
+    response->addHeader("Access-Control-Max-Age", maxAge_);
+    req->send(response);
+    return false;
+}
+
+void AsyncCorsMiddleware::after(AsyncWebServerRequest* req [[maybe_unused]], AsyncWebServerResponse* response)
+{
+    response->addHeader("Access-Control-Allow-Origin", origin_);
+}
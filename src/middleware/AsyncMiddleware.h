@@ -0,0 +1,110 @@
+#ifndef ASYNCMIDDLEWARE_H_
+#define ASYNCMIDDLEWARE_H_
+
+#include <concepts>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <stdint.h>
+
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+
+
+/// @brief 中间件链（服务器或处理器各持有一条，每个阶段一次虚函数调用）
+class AsyncMiddleware {
+public:
+    virtual ~AsyncMiddleware(){}
+    /// @brief 请求头解析完成、调用处理器之前执行
+    /// @return false表示已发送响应（如401、429），不再执行后续中间件与处理器，请求体直接丢弃
+    virtual bool before(AsyncWebServerRequest* req) = 0;
+    /// @brief 响应开始发送之前执行（可添加响应头），before()拦截时发送的响应同样经过
+    virtual void after(AsyncWebServerRequest* req, AsyncWebServerResponse* response) = 0;
+};
+
+
+/// @brief 编译期组合的中间件链：各阶段按值保存，before()依次调用（返回false时短路），after()逆序调用
+/*
+ * 阶段为任意类型，按其提供的成员确定参与的阶段（不需要继承或虚函数，调用可内联）：
+ * 1. bool before(AsyncWebServerRequest*)：前置阶段
+ * 2. void after(AsyncWebServerRequest*, AsyncWebServerResponse*)：后置阶段
+ * 3. 可以bool(AsyncWebServerRequest*)调用的函数对象（如lambda）：前置阶段
+*/
+template <typename... Stages>
+class AsyncMiddlewareChain : public AsyncMiddleware {
+public:
+    explicit AsyncMiddlewareChain(Stages... stages)
+        : stages_(std::move(stages)...)
+    {
+    }
+
+    bool before(AsyncWebServerRequest* req) override {
+        return beforeAll(req, std::index_sequence_for<Stages...>());
+    }
+    void after(AsyncWebServerRequest* req, AsyncWebServerResponse* response) override {
+        afterAll(req, response, std::index_sequence_for<Stages...>());
+    }
+    /// @brief 获取第I个阶段（用于运行中调整参数或读取统计）
+    template <size_t I>
+    auto& stage() {
+        return std::get<I>(stages_);
+    }
+
+private:
+    template <typename Stage>
+    static bool runBefore(Stage& stage, AsyncWebServerRequest* req) {
+        if constexpr (requires { { stage.before(req) } -> std::convertible_to<bool>; }) {
+            return stage.before(req);
+        } else if constexpr (std::is_invocable_r_v<bool, Stage&, AsyncWebServerRequest*>) {
+            return stage(req);
+        } else {
+            return true;
+        }
+    }
+    template <typename Stage>
+    static void runAfter(Stage& stage, AsyncWebServerRequest* req, AsyncWebServerResponse* response) {
+        if constexpr (requires { stage.after(req, response); }) {
+            stage.after(req, response);
+        }
+    }
+    template <size_t... I>
+    bool beforeAll(AsyncWebServerRequest* req, std::index_sequence<I...>) {
+        return (runBefore(std::get<I>(stages_), req) && ...);
+    }
+    template <size_t... I>
+    void afterAll(AsyncWebServerRequest* req, AsyncWebServerResponse* response, std::index_sequence<I...>) {
+        (runAfter(std::get<sizeof...(Stages) - 1 - I>(stages_), req, response), ...);
+    }
+
+    std::tuple<Stages...>   stages_;    // 各阶段（按注册顺序）
+};
+
+/// @brief 创建中间件链（由server.use()或handler.use()接管）
+/// 如：server.use(middleware(AsyncCorsMiddleware("*"), [](AsyncWebServerRequest* req){ return true; }));
+template <typename... Stages>
+AsyncMiddleware* middleware(Stages&&... stages)
+{
+    return new AsyncMiddlewareChain<std::decay_t<Stages>...>(std::forward<Stages>(stages)...);
+}
+
+
+/// @brief 跨域资源共享：直接应答预检请求（OPTIONS），并为其余响应添加Access-Control-Allow-Origin
+class AsyncCorsMiddleware {
+public:
+    explicit AsyncCorsMiddleware(const char* origin = "*",
+                                 const char* methods = "GET, POST, PUT, DELETE, OPTIONS",
+                                 const char* headers = "Content-Type, Authorization",
+                                 uint32_t maxAge = 86400);
+
+    bool before(AsyncWebServerRequest* req);
+    void after(AsyncWebServerRequest* req, AsyncWebServerResponse* response);
+
+private:
+    std::string     origin_;    // 允许的来源
+    std::string     methods_;   // 预检应答中允许的方法
+    std::string     headers_;   // 预检应答中允许的请求头
+    std::string     maxAge_;    // 预检结果的缓存时间（秒）
+};
+
+#endif // !ASYNCMIDDLEWARE_H_
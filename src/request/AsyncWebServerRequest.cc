@@ -10,6 +10,7 @@
 #include "../response/AsyncCallbackResponse.h"
 #include "../response/AsyncProgmemResponse.h"
 #include "../response/AsyncFileResponse.h"
+#include "../response/AsyncResponseStream.h"
 #include "../handler/AsyncWebHandler.h"
 #include "../WebAuthentication.h"
 #include "../tools.h"
@@ -43,7 +44,7 @@ void AsyncWebServerRequest::reset()
     auto* tmp = fileName_;
     fileName_ = nullptr;
     if (tmp) {
-        delete tmp;
+        delete[] tmp;
     }
 }
 
@@ -60,6 +61,7 @@ void AsyncWebServerRequest::init(AsyncWebServer* server, AsyncClient* client)
     server_     = server;
     handler_    = nullptr;
     response_   = nullptr;
+    middleware_ = nullptr;
     interestingHeaders_.free();  
     onDisconnectfn_     = nullptr;
 
@@ -151,14 +153,10 @@ void AsyncWebServerRequest::onErr(err_t error)
 /// @param time
 void AsyncWebServerRequest::onAck(size_t len, uint32_t time)
 {
-    if (response_ != nullptr) {
-        if (response_->finished()) {
-            auto* response = response_;
-            response_ = nullptr;
-            delete response;
-        } else {
-            response_->ack(this, len, time);
-        }
+    if (response_ != nullptr && response_->acknowledge(this, len, time)) {
+        auto* response = response_;
+        response_ = nullptr;
+        delete response;
     }
 }
 
@@ -176,9 +174,8 @@ void AsyncWebServerRequest::onPoll()
 {
     if (response_ != nullptr
             && client_ != nullptr
-            && client_->get_send_buffer_size()
-            && !(response_->finished())) {
-        response_->ack(this, 0, 0);
+            && client_->get_send_buffer_size()) {
+        response_->acknowledge(this, 0, 0);
     }
 }
 
@@ -293,8 +290,12 @@ void AsyncWebServerRequest::parseLine(char* start, char* end) //C++17
             parseReqHeader(start, end);
         } else {
             // 遇到空行，请求头处理结束
-            server_->internalRewriteRequest(this);      // 执行重写检查（符合时重写）
-            server_->internalAttachHandler(this);       // 绑定处理函数
+            server_->internalRouteRequest(this);        // 执行重写检查（符合时重写）并绑定处理函数
+            // 中间件与认证在过滤请求头之前执行，可读取全部请求头
+            if (!server_->internalBeforeRequest(this)) {
+                parseState_ = PARSE_REQ_END;    // 中间件已发送响应：不再调用处理器，请求体直接丢弃
+                return;
+            }
             removeNotInterestingHeaders();      // 过滤不关心的头
             if (expectingContinue_) {
                 static const char* response = "HTTP/1.1 100 Continue\r\n\r\n";
@@ -413,9 +414,8 @@ void AsyncWebServerRequest::parseReqLine(char* start, char* end)
         url_.assign(url_start, space2 - url_start);
     }
 
-    if (memcmp((void*)(space2 + 1), "HTTP/1.0", 8) == 0) {
-        version_ = 1;
-    }
+    // version_为次版本号：0=HTTP/1.0，1=HTTP/1.1（响应头组装、chunked编码据此判断）
+    version_ = (memcmp((void*)(space2 + 1), "HTTP/1.0", 8) == 0) ? 0 : 1;
 }
 
 /// @brief 获取请求行中的GET参数，存储到参数列表中，[start, end)
@@ -443,7 +443,7 @@ void AsyncWebServerRequest::addGetParams(const char* start, const char* end)
 }
 
 /// @brief 解析URL中编码的字符串[start, end)
-std::string AsyncWebServerRequest::urlDecode(const char* start, const char* end) const
+std::string AsyncWebServerRequest::urlDecode(const char* start, const char* end)
 {
     char tmp[] = "0x00";
     char decoded;
@@ -453,9 +453,10 @@ std::string AsyncWebServerRequest::urlDecode(const char* start, const char* end)
 
     while (start < end) {
         if ((*start == '%') && (start + 2 < end)) {
-            tmp[2] = *(start++);
-            tmp[3] = *(start++);
+            tmp[2] = start[1];
+            tmp[3] = start[2];
             decoded = strtol(tmp, nullptr, 16);
+            start += 3;
         } else if (*start == '+') {
             decoded = ' ';
             start ++;
@@ -990,6 +991,7 @@ void AsyncWebServerRequest::send(AsyncWebServerResponse* response)
     
     if (response_->sourceValid()) {
         client_->set_rx_timeout_second(0);
+        server_->internalAfterRequest(this, response_);
         response_->respond(this);
     } else {
         delete response_;
@@ -1005,7 +1007,7 @@ void AsyncWebServerRequest::send(AsyncWebServerResponse* response)
 /// @param callback 采用的模板处理函数
 void AsyncWebServerRequest::send(std::string path, std::string contentType, bool download, AwsTemplateProcessor callback)
 {
-    if (FILE_EXISTS(path.c_str()) || (!download && FILE_EXISTS(std::string(path + ".gz").c_str()))) {
+    if (FILE_EXISTS(path.c_str()) || (!download && AsyncFileResponse::availableEncodings(path))) {
         send(beginResponse(std::move(path), std::move(contentType), download, std::move(callback)));
     } else {
         send(404);
@@ -1024,6 +1026,23 @@ void AsyncWebServerRequest::send_P(int code, std::string contentType, const uint
     send(beginResponse_P(code, std::move(contentType), content, len, std::move(callback)));
 }
 
+/// @brief 发送一个文件模板响应，占位符的值由writer直接写入输出
+void AsyncWebServerRequest::sendTemplate(std::string path, std::string contentType, AwsTemplateWriter writer)
+{
+    auto* response = beginTemplateResponse(std::move(path), std::move(contentType), std::move(writer));
+    if (response) {
+        send(response);
+    } else {
+        send(404);
+    }
+}
+
+/// @brief 发送一个内存模板响应，占位符的值由writer直接写入输出
+void AsyncWebServerRequest::sendTemplate_P(int code, std::string contentType, const uint8_t* content, size_t len, AwsTemplateWriter writer)
+{
+    send(beginTemplateResponse_P(code, std::move(contentType), content, len, std::move(writer)));
+}
+
 
 
 /// @brief 检查是否包含某个请求头
@@ -1128,6 +1147,13 @@ const std::string &AsyncWebServerRequest::argName(size_t index) const
     return param != nullptr ? param->name() : empty_string;
 }
 
+/// @brief 获取指定索引的路径参数（路由参数段或正则捕获组）
+const std::string& AsyncWebServerRequest::pathArg(size_t i) const
+{
+    auto* param = pathParams_.nth(i);
+    return param != nullptr ? **param : empty_string;
+}
+
 /// @brief 检查是否含有指定名字的参数
 bool AsyncWebServerRequest::hasArg(const char* name) const
 {
@@ -1170,6 +1196,25 @@ AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, std::stri
     return new AsyncBasicResponse(code, std::move(contentType), std::move(content));
 }
 
+/// @brief 构建一个以静态存储为响应体的基本响应（发送时不拷贝数据）
+/// @param code 响应状态码
+/// @param contentType 内容类型
+/// @param content 响应内容（须在程序运行期间保持有效且不变，如字符串字面量）
+/// @param len 响应内容长度
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, std::string contentType, const char* content, size_t len)
+{
+    return new AsyncBasicResponse(code, std::move(contentType), content, len);
+}
+
+/// @brief 构建一个以共享缓冲区为响应体的基本响应（发送时不拷贝数据，响应持有引用直至数据被确认）
+/// @param code 响应状态码
+/// @param contentType 内容类型
+/// @param content 共享的响应内容（可同时被多个响应引用）
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, std::string contentType, AwsSharedBuffer content)
+{
+    return new AsyncBasicResponse(code, std::move(contentType), std::move(content));
+}
+
 /// @brief 构建一个文件响应
 /// @param path 文件路径
 /// @param contentType 内容类型
@@ -1177,7 +1222,7 @@ AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, std::stri
 /// @param callback 模板处理函数
 AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(std::string path, std::string contentType, bool download, AwsTemplateProcessor callback)
 {
-    if (FILE_EXISTS(path.c_str()) || (!download && FILE_EXISTS(std::string(path + ".gz").c_str()))) {
+    if (FILE_EXISTS(path.c_str()) || (!download && AsyncFileResponse::availableEncodings(path))) {
         return new AsyncFileResponse(std::move(path), std::move(contentType), download, std::move(callback));
     }
     return nullptr;
@@ -1217,27 +1262,33 @@ AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, std::st
   return new AsyncProgmemResponse(code, std::move(contentType), content, len, std::move(callback));
 }
 
+/// @brief 构建一个文件模板响应
+/// @param path 文件路径
+/// @param contentType 内容类型
+/// @param writer 将占位符的值直接写入输出的回调
+AsyncWebServerResponse* AsyncWebServerRequest::beginTemplateResponse(std::string path, std::string contentType, AwsTemplateWriter writer)
+{
+    if (!FILE_EXISTS(path.c_str())) {
+        return nullptr;
+    }
+    auto* response = new AsyncFileResponse(std::move(path), std::move(contentType));
+    response->setTemplateWriter(std::move(writer));
+    return response;
+}
 
+/// @brief 构建一个内存模板响应
+/// @param content 模板数据（须在程序运行期间保持不变）
+/// @param writer 将占位符的值直接写入输出的回调
+AsyncWebServerResponse* AsyncWebServerRequest::beginTemplateResponse_P(int code, std::string contentType, const uint8_t *content, size_t len, AwsTemplateWriter writer)
+{
+    auto* response = new AsyncProgmemResponse(code, std::move(contentType), content, len);
+    response->setTemplateWriter(std::move(writer));
+    return response;
+}
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+/// @brief 构建一个流式响应：处理器逐步写入内容后调用send()发送
+/// @param contentType 内容类型
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(std::string contentType)
+{
+    return new AsyncResponseStream(std::move(contentType));
+}
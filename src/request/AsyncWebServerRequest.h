@@ -6,6 +6,7 @@
 #include "../StringArray.h"
 #include "lwip/err.h"
 #include "../handler/AsyncStaticWebHandler.h"
+#include "../response/AsyncWebServerResponse.h"
 #include "AsyncClient.h"
 
 
@@ -22,8 +23,9 @@ class AsyncStaticWebHandler;
 class AsyncCallbackWebHandler;
 class AsyncWebSocket;
 class AsyncWebSocketResponse;
+class AsyncMiddleware;
 
-// class AsyncResponseStream;
+class AsyncResponseStream;
 
 
 typedef enum {
@@ -136,7 +138,11 @@ public:
     void addInterestingHeader(std::string name);
     void redirect(std::string url);
 
-    // const std::string& ASYNCWEBSERVER_REGEX_ATTRIBUTE pathArg(size_t i) const;
+    const std::string& pathArg(size_t i) const;
+    /// @brief 获取路径参数个数
+    size_t pathArgs() const {
+        return pathParams_.length();
+    }
 
     void send(AsyncWebServerResponse* response);
     /// @brief 发送一个基本的响应
@@ -146,17 +152,30 @@ public:
     void send(int code, std::string contentType="", std::string content="") {
         send(beginResponse(code, std::move(contentType), std::move(content)));
     }
+    /// @brief 发送一个以静态存储为响应体的基本响应（免拷贝）
+    void send(int code, std::string contentType, const char* content, size_t len) {
+        send(beginResponse(code, std::move(contentType), content, len));
+    }
+    /// @brief 发送一个以共享缓冲区为响应体的基本响应（免拷贝）
+    void send(int code, std::string contentType, AwsSharedBuffer content) {
+        send(beginResponse(code, std::move(contentType), std::move(content)));
+    }
     void send(std::string path, std::string contentType="", bool download=false, AwsTemplateProcessor callback=nullptr);
     void sendChunked(std::string contentType, AwsResponseFiller callback, AwsTemplateProcessor templateCallback=nullptr);
     void send_P(int code, std::string contentType, const uint8_t* content, size_t len, AwsTemplateProcessor callback=nullptr);
+    void sendTemplate(std::string path, std::string contentType, AwsTemplateWriter writer);
+    void sendTemplate_P(int code, std::string contentType, const uint8_t* content, size_t len, AwsTemplateWriter writer);
 
     AsyncWebServerResponse* beginResponse(int code, std::string contentType ="", std::string content="");
+    AsyncWebServerResponse* beginResponse(int code, std::string contentType, const char* content, size_t len);
+    AsyncWebServerResponse* beginResponse(int code, std::string contentType, AwsSharedBuffer content);
     AsyncWebServerResponse* beginResponse(std::string path, std::string contentType ="", bool download = false, AwsTemplateProcessor callback = nullptr);
     AsyncWebServerResponse* beginResponse(std::string contentType, size_t len, AwsResponseFiller callback, AwsTemplateProcessor templateCallback = nullptr);
     AsyncWebServerResponse* beginChunkedResponse(std::string contentType, AwsResponseFiller callback, AwsTemplateProcessor templateCallback = nullptr);
     AsyncWebServerResponse* beginResponse_P(int code, std::string contentType, const uint8_t *content, size_t len, AwsTemplateProcessor callback = nullptr);
-    // 暂不实现流式响应，通过chunked间接可完成
-    // AsyncResponseStream *beginResponseStream(const std::string &contentType, size_t bufferSize = 1460);
+    AsyncWebServerResponse* beginTemplateResponse(std::string path, std::string contentType, AwsTemplateWriter writer);
+    AsyncWebServerResponse* beginTemplateResponse_P(int code, std::string contentType, const uint8_t *content, size_t len, AwsTemplateWriter writer);
+    AsyncResponseStream* beginResponseStream(std::string contentType);
 
 
 private:
@@ -168,6 +187,8 @@ private:
     friend class AsyncWebServerResponse;   // 响应基类
     friend class AsyncBasicResponse;       // 基本响应
     friend class AsyncAbstractResponse;    // 抽象响应
+    friend class AsyncResponseStream;      // 流式响应
+    friend class AsyncFileResponse;        // 文件响应（协商预压缩文件）
     friend class AsyncWebRewrite;          // URL重写
     friend class DefaultHeaders;           // 默认头部
     friend class AsyncWebSocketResponse;
@@ -195,6 +216,9 @@ private:
     void addPathParam(const char* param) {
         pathParams_.add(new std::string(param));
     }
+    void addPathParam(const char* param, size_t len) {
+        pathParams_.add(new std::string(param, len));
+    }
 
     void parseReqLine(char* start, char* end);
     bool parseReqHeader(const char* start, const char* end);
@@ -203,7 +227,7 @@ private:
     void parseMultiPartLine(uint8_t* start, uint8_t* end);
     void handleMultipartBody(void* buf, size_t len);
     void addGetParams(const char* start, const char* end);
-    std::string urlDecode(const char* start, const char* end) const;
+    static std::string urlDecode(const char* start, const char* end);
 
     void handleUpload(uint8_t* data, size_t len, bool last);           
 
@@ -216,12 +240,13 @@ private:
     AsyncWebServer*         server_;                    // 关联的服务器
     AsyncWebHandler*        handler_{nullptr};          // 处理该请求的处理器
     AsyncWebServerResponse* response_{nullptr};         // 当前请求的响应对象
+    AsyncMiddleware*        middleware_{nullptr};       // 处理器的中间件链（响应发送前执行其后置阶段）
     StringArray             interestingHeaders_;        // 关注的请求头
     ArDisconnectHandler     onDisconnectfn_{nullptr};   // 
 
     LinkedList<AsyncWebHeader*>     headers_;       // 所有的请求头
     LinkedList<AsyncWebParameter*>  params_;        // 请求参数（包括请求参数、表单数据、文件）
-    LinkedList<std::string*>        pathParams_;    // 
+    LinkedList<std::string*>        pathParams_;    // 路径参数（路由参数段或正则捕获组）
 
     std::string             tmp_{};
     bool                    isFragmented_{false};
@@ -1,10 +1,24 @@
 #include "AsyncAbstractResponse.h"
 #include "../request/AsyncWebServerRequest.h"
 #include "AsyncClient.h"
+#include "../header/AsyncWebHeader.h"
+#include "../tools.h"
+#include "my_sysInfo.h"
 
 AsyncAbstractResponse::AsyncAbstractResponse(AwsTemplateProcessor cb)
     : callback_(cb)
-    , headerSent_(0)
+    , templatable_(true)
+    , rangeable_(false)
+    , compressible_(false)
+    , lastChunk_(false)
+    , cacheHead_(0)
+    , segmentIndex_(0)
+    , segmentOffset_(0)
+    , sourceOffset_(0)
+    , valueReady_(false)
+    , gzipLevel_(CONFIG_GZIP_LEVEL)
+    , rawLimit_(0)
+    , rawLength_(0)
 {
     if (cb) {
         contentLength_ = 0;
@@ -13,145 +27,522 @@ AsyncAbstractResponse::AsyncAbstractResponse(AwsTemplateProcessor cb)
     }
 }
 
-/// @brief 发送响应
+/// @brief 发送响应：响应头之后为一个由数据源生成的数据段
+/// HEAD请求只发送响应头（含真实的Content-Length），不打开数据源，也不执行模板处理；无响应体（长度为0）时同样
 void AsyncAbstractResponse::respond(AsyncWebServerRequest* req)
 {
     addHeader("Connection", "close");
-    header_ = assembleHead(req->version_);
+    setupCompression(req);
+    if (chunked_ && !trailerNames_.empty()) {
+        addHeader("Trailer", trailerNames_);
+    }
+    bool rangeable = rangeable_ && !callback_ && !chunked_ && sendContentLength_ && code_ == 200;
+    bool empty = !chunked_ && sendContentLength_ && contentLength_ == 0;
+    if (req->method_ == HTTP_HEAD || empty) {
+        acceptRanges_ = rangeable;
+        addSegment(assembleHead(req->version_));
+    } else {
+        if (!openSource()) {
+            fail(req->client_);
+            return;
+        }
+        if (callback_ && templatable_ && !template_) {
+            template_ = compileTemplate();
+        }
+        if (rangeable) {
+            applyRanges(req);
+        } else {
+            addSegment(assembleHead(req->version_));
+            addSource();
+        }
+    }
     state_ = RESPONSE_HEADERS;
-    ack(req, 0, 0);
+    acknowledge(req, 0, 0);
 }
 
+/// @brief 内容类型是否值得压缩（文本类）
+static bool isCompressible(const std::string& type)
+{
+    return type.compare(0, 5, "text/") == 0
+        || type.find("json") != std::string::npos
+        || type.find("javascript") != std::string::npos
+        || type.find("xml") != std::string::npos;
+}
 
-size_t AsyncAbstractResponse::ack(AsyncWebServerRequest* req, size_t len,  uint32_t time)
+/// @brief 客户端接受gzip且内容类型可压缩时，响应体以流式gzip压缩后chunked发送（原始数据的声明长度仍限制读取量）
+/// 进行中的压缩流已达CONFIG_GZIP_MAX_STREAMS时不压缩
+void AsyncAbstractResponse::setupCompression(AsyncWebServerRequest* req)
 {
-    auto* client = req->client_;
-    if (!sourceValid()) {
-        client->close();
-        return 0;
+    if (!compressible_ || !gzipLevel_ || req->version_ == 0 || code_ != 200 || !isCompressible(contentType_)) {
+        return;
     }
-
-    ackedLength_ += len;
-    auto header_length = header_.length();
-    if (ackedLength_ >= header_length && !header_.empty()) {
-        std::string().swap(header_);    // 释放头部空间
+    for (const auto& header : headers_) {
+        if (strcasecmp(header->name().c_str(), "Content-Encoding") == 0) {
+            return;
+        }
     }
-
-    
-    size_t sent_bytes = 0;
-    auto space = client->get_send_buffer_size();
-    if (state_ == RESPONSE_HEADERS) {
-        auto headerRemaining = header_length - headerSent_;
-        if (headerRemaining > 0) {
-            auto toSend = std::min(headerRemaining, space);
-            size_t sent = client->add(header_.c_str() + headerSent_, toSend, TCP_WRITE_FLAG_COPY);
-            if (sent) {
-                headerSent_ += sent;
-                sent_bytes += sent;
-                writtenLength_ += sent;
-                space -= sent;
-            }
+    if (sendContentLength_ && contentLength_ < CONFIG_GZIP_MIN_LENGTH) {
+        return;
+    }
+    addHeader("Vary", "Accept-Encoding");
+    if (!req->hasHeader("Accept-Encoding") || encodingQuality(req->header("Accept-Encoding").c_str(), "gzip") == 0) {
+        return;
+    }
+    if (req->method_ == HTTP_HEAD) {
+        if (!AsyncGzipEncoder::available()) {
+            return;
         }
+    } else {
+        gzip_.reset(AsyncGzipEncoder::create(gzipLevel_));
+        if (!gzip_) {
+            return;
+        }
+    }
+    addHeader("Content-Encoding", "gzip");
+    rawLimit_ = sendContentLength_ ? contentLength_ : 0;
+    contentLength_ = 0;
+    sendContentLength_ = false;
+    chunked_ = true;
+}
 
-        if (headerSent_ >= header_length) {
-            // 头部数据已完全写入
-            state_ = RESPONSE_CONTENT;   
-            if ((space == 0) || (chunked_ && (space < 8))) {    // 空间用尽、不足够chunked
-                client->send();
-                return sent_bytes;
+/// @brief 处理范围请求并组装数据段：单个范围以206发送该范围，多个范围以multipart/byteranges发送，均不可满足时返回416
+/// If-Range与响应的ETag/Last-Modified不一致时忽略Range，发送完整内容
+void AsyncAbstractResponse::applyRanges(AsyncWebServerRequest* req)
+{
+    acceptRanges_ = true;
+    std::vector<AsyncByteRange> ranges;
+    int count = 0;
+    auto& range = req->header("Range");
+    if (!range.empty()) {
+        bool matched = true;
+        if (req->hasHeader("If-Range")) {
+            const std::string* etag = &empty_string;
+            time_t modifiedAt = -1;
+            for (const auto& header : headers_) {
+                if (strcasecmp(header->name().c_str(), "ETag") == 0) {
+                    etag = &header->value();
+                } else if (strcasecmp(header->name().c_str(), "Last-Modified") == 0) {
+                    modifiedAt = parseHttpDate(header->value().c_str());
+                }
             }
-        } else {     
-            // 头部数据未完全写入                               
-            client->send();
-            return sent_bytes;
+            matched = ifRangeMatches(req->header("If-Range").c_str(), *etag, modifiedAt);
+        }
+        if (matched) {
+            count = parseRanges(range.c_str(), contentLength_, ranges, CONFIG_MAX_RANGES);
         }
-        
     }
 
-    // 发送响应体
-    if (state_ == RESPONSE_CONTENT && (space > 0)) {
-        if(chunked_ && space < 8) {
+    auto size = std::to_string(contentLength_);
+    if (count < 0) {
+        code_ = 416;
+        addHeader("Content-Range", "bytes */" + size);
+        contentLength_ = 0;
+        addSegment(assembleHead(req->version_));
+        return;
+    }
+    if (count == 0) {
+        addSegment(assembleHead(req->version_));
+        addSource();
+        return;
+    }
+
+    code_ = 206;
+    auto contentRange = [&size](const AsyncByteRange& r) {
+        return "bytes " + std::to_string(r.offset) + "-" + std::to_string(r.offset + r.length - 1) + "/" + size;
+    };
+    if (count == 1) {
+        addHeader("Content-Range", contentRange(ranges[0]));
+        contentLength_ = ranges[0].length;
+        addSegment(assembleHead(req->version_));
+        addSource(ranges[0].offset, ranges[0].length);
+        return;
+    }
+
+    // multipart/byteranges：各部分的分隔行与部分头作为内存数据段，与范围数据段交替排列
+    char boundary[24];
+    snprintf(boundary, sizeof(boundary), "RANGE_%08x", (unsigned)SystemInfo::GetMsSinceStart());
+    auto partType = contentType_;
+    contentType_ = "multipart/byteranges; boundary=";
+    contentType_ += boundary;
+
+    std::vector<std::string> parts;
+    contentLength_ = 0;
+    for (auto& r : ranges) {
+        std::string part = parts.empty() ? "--" : "\r\n--";
+        part += boundary;
+        part += "\r\nContent-Type: ";
+        part += partType;
+        part += "\r\nContent-Range: ";
+        part += contentRange(r);
+        part += "\r\n\r\n";
+        contentLength_ += part.length() + r.length;
+        parts.push_back(std::move(part));
+    }
+    std::string tail = "\r\n--";
+    tail += boundary;
+    tail += "--\r\n";
+    contentLength_ += tail.length();
+
+    addSegment(assembleHead(req->version_));
+    for (size_t i = 0; i < ranges.size(); i++) {
+        addSegment(std::move(parts[i]));
+        addSource(ranges[i].offset, ranges[i].length);
+    }
+    addSegment(std::move(tail));
+}
+
+/// @brief 写入响应体中的一个范围（segment.offset起的segment.length字节），可直接引用的数据源免拷贝发送
+size_t AsyncAbstractResponse::writeRange(AsyncClient* client, AsyncResponseSegment& segment, size_t space)
+{
+    auto position = segment.offset + segment.written;
+    auto toSend = std::min(segment.length - segment.written, space);
+    size_t view_len = 0;
+    size_t sent;
+    auto* view = contentAt(position, view_len);
+    if (view != nullptr) {
+        sent = client->add((const char*)view, std::min(view_len, toSend), 0);
+    } else {
+        if (toSend > buffer_.size()) {
+            buffer_.resize(toSend);
+        }
+        auto read_len = seekContent(position) ? fillBuffer(buffer_.data(), toSend) : 0;
+        if (read_len == 0 || read_len == RESPONSE_TRY_AGAIN) {
+            // 数据源短于声明的长度（发送后被修改），无法继续
+            fail(client);
             return 0;
         }
-        // 获取本次发送需要的缓冲区大小
-        size_t buffer_size = 0;
-        size_t data_size = 0;
-        if (contentLength_) {
-            buffer_size = std::min(contentLength_ - sentLength_, space);
-            data_size = buffer_size;
-            if (chunked_) buffer_size += 8;
-        } else {
-            if (chunked_) {
-                data_size = space - 8;
-                buffer_size = space;
-            } else {
-                data_size = space;
-                buffer_size = data_size;
-            }
+        sent = client->add((const char*)buffer_.data(), read_len, TCP_WRITE_FLAG_COPY);
+    }
+    segment.done = segment.written + sent >= segment.length;
+    return sent;
+}
+
+/// @brief 向发送队列写入不超过space字节的响应体（不立即发送）
+/// @return 写入的字节数
+size_t AsyncAbstractResponse::writeSource(AsyncClient* client, AsyncResponseSegment& segment, size_t space)
+{
+    if (segment.length) {
+        return writeRange(client, segment, space);
+    }
+
+    // 数据源不变且无需模板处理时：直接引用原始数据发送，跳过fillBuffer及协议栈拷贝
+    size_t view_len = 0;
+    const uint8_t* view = (chunked_ || callback_) ? nullptr : contentAt(sentLength_, view_len);
+    if (view != nullptr) {
+        auto sent = client->add((const char*)view, std::min(view_len, space), 0);
+        sentLength_ += sent;
+        segment.done = sentLength_ >= contentLength_;
+        return sent;
+    }
+    if (chunked_) {
+        return writeChunks(client, segment, space);
+    }
+
+    // 获取本次发送需要的缓冲区大小
+    size_t data_size = space;
+    if (contentLength_) {
+        data_size = std::min(contentLength_ - sentLength_, space);
+    }
+    if (data_size > buffer_.size()) {
+        buffer_.resize(data_size);
+    }
+
+    // 填充数据
+    auto* buf = buffer_.data();
+    auto read_len = fillBufferAndProcessTemplates(buf, data_size);
+    if (read_len == RESPONSE_TRY_AGAIN) {
+        return 0;
+    } 
+    if (read_len == 0 && !sourceValid()) {
+        // 数据源读取出错（而非结束），无法继续
+        fail(client);
+        return 0;
+    }
+
+    // 向发送队列写入数据（缓冲区会被复用，须拷贝）
+    auto write_len = client->add((const char*)buf, read_len, TCP_WRITE_FLAG_COPY);
+    sentLength_ += read_len;
+
+    if ((!sendContentLength_ && read_len == 0)          // 无声明长度（Sever-Sent Events、动态流），本次无数据
+        || (sentLength_ == contentLength_)) {           // 发送的长度达到声明长度
+            segment.done = true;
+    }
+    
+    return write_len;
+}
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/// @brief 计算n的十六进制位数（至少1位）
+static inline size_t hexWidth(size_t n)
+{
+    size_t width = 1;
+    while (n >>= 4) {
+        width++;
+    }
+    return width;
+}
+
+/// @brief 以最小宽度写入分块头"<hex>\r\n"，使其恰好结束于end
+/// @return 分块头起始位置
+static inline uint8_t* writeChunkHead(uint8_t* end, size_t n)
+{
+    *(--end) = '\n';
+    *(--end) = '\r';
+    do {
+        *(--end) = hex_digits[n & 0x0f];
+        n >>= 4;
+    } while (n);
+    return end;
+}
+
+/// @brief 以chunked编码写入响应体：尽量填满发送窗口，结束块（含trailer）与最后的数据块合并写入
+/// @return 写入的字节数
+size_t AsyncAbstractResponse::writeChunks(AsyncClient* client, AsyncResponseSegment& segment, size_t space)
+{
+    if (space > buffer_.size()) {
+        buffer_.resize(space);
+    }
+    auto* buf = buffer_.data();
+    uint8_t* start = nullptr;   // 本轮待写入数据的起始位置
+    size_t used = 0;            // 缓冲区已使用的字节数
+
+    while (!lastChunk_) {
+        size_t room = space - used;
+        size_t head_max = hexWidth(room) + 2;   // 按最大可能长度预留分块头
+        if (room < head_max + 2 + 1) {          // 至少能容纳1字节数据
+            break;
         }
-        if (buffer_size > buffer_.size()) {
-            buffer_.resize(buffer_size);
+        auto* data = buf + used + head_max;
+        auto read_len = fillBody(data, room - head_max - 2);
+        if (read_len == RESPONSE_TRY_AGAIN) {
+            break;
+        }
+        if (read_len == 0) {
+            if (!sourceValid()) {
+                // 数据源读取出错（而非结束），不发送结束块
+                fail(client);
+                return 0;
+            }
+            lastChunk_ = true;
+            break;
         }
 
-        // 填充数据
-        auto* buf = buffer_.data();
-        auto read_len = fillBufferAndProcessTemplates(chunked_ ? buf + 6 : buf, data_size);
-        if (read_len == RESPONSE_TRY_AGAIN) {
-            return 0;
-        } 
-        if (chunked_) {
-            // 填充头尾
-            sprintf((char*)buf, "%04x\r", read_len);   // FFFF\r\0
-            buf[5] = '\n';
-            buf[read_len + 6] = '\r'; 
-            buf[read_len + 7] = '\n'; 
-        }
-
-        // 向客户端写入数据
-        auto write_len = client->write((const char*)buf, buffer_size);
-        writtenLength_ += write_len;
+        auto* head = writeChunkHead(data, read_len);
+        auto chunk_len = data + read_len - head;
+        auto* chunk = buf + used;
+        if (start == nullptr) {
+            chunk = start = head;               // 首块直接使用实际位置，前方预留的空隙不发送
+        } else if (head != chunk) {
+            memmove(chunk, head, chunk_len);    // 后续块头部短于预留时前移，保证数据连续
+        }
+        chunk[chunk_len] = '\r';
+        chunk[chunk_len + 1] = '\n';
+        used = chunk + chunk_len + 2 - buf;
         sentLength_ += read_len;
+    }
 
-        if ((chunked_ && read_len == 0)                         // chunked,时本次无数据
-            || (!sendContentLength_ && read_len == 0)          // 无声明长度（Sever-Sent Events、动态流），本次无数据
-            || (!chunked_ && sentLength_ == contentLength_)) {  // 非chunked,发送的长度超过声明长度
-                state_ = RESPONSE_WAIT_ACK;
-        }
-        
-        return write_len;
-    } else if (state_ == RESPONSE_WAIT_ACK) {
-        if (!sendContentLength_ || ackedLength_ >= writtenLength_) {
-            state_ = RESPONSE_END;
-            if (!chunked_ && !sendContentLength_) {
-                client->close();
+    if (lastChunk_) {
+        // 结束块：0\r\n + trailer + \r\n
+        size_t tail_len = 3 + trailers_.length() + 2;
+        if (tail_len <= space - used) {
+            auto* tail = buf + used;
+            memcpy(tail, "0\r\n", 3);
+            memcpy(tail + 3, trailers_.data(), trailers_.length());
+            memcpy(tail + 3 + trailers_.length(), "\r\n", 2);
+            if (start == nullptr) {
+                start = tail;
+            }
+            used += tail_len;
+            segment.done = true;
+        }
+    }
+
+    if (start == nullptr) {
+        return 0;
+    }
+    return client->add((const char*)start, buf + used - start, TCP_WRITE_FLAG_COPY);
+}
+
+/// @brief 读取chunked响应体数据（启用压缩时为压缩后的数据）
+size_t AsyncAbstractResponse::fillBody(uint8_t* buf, size_t max_len)
+{
+    if (gzip_) {
+        return fillCompressed(buf, max_len);
+    }
+    return fillBufferAndProcessTemplates(buf, max_len);
+}
+
+/// @brief 读取压缩后的响应体：压缩输出不足时从数据源读取原始数据送入压缩器
+/// 数据源暂无数据时先刷新压缩流，已写入的数据及时送达客户端
+/// @return 写入的字节数（为0表示压缩流结束），暂无数据时返回RESPONSE_TRY_AGAIN
+size_t AsyncAbstractResponse::fillCompressed(uint8_t* buf, size_t max_len)
+{
+    while (gzip_->pending() < max_len && !gzip_->finished()) {
+        size_t want = CONFIG_GZIP_INPUT_BLOCK;
+        if (rawLimit_) {
+            want = std::min(want, rawLimit_ - rawLength_);
+        }
+        size_t read_len = 0;
+        if (want) {
+            raw_.resize(CONFIG_GZIP_INPUT_BLOCK);
+            read_len = fillBufferAndProcessTemplates(raw_.data(), want);
+        }
+        if (read_len == RESPONSE_TRY_AGAIN) {
+            gzip_->flush();
+            if (gzip_->pending() == 0) {
+                return RESPONSE_TRY_AGAIN;
             }
+            break;
         }
+        if (read_len == 0) {
+            gzip_->finish();
+            std::vector<uint8_t>().swap(raw_);
+            break;
+        }
+        rawLength_ += read_len;
+        gzip_->write(raw_.data(), read_len);
     }
+    return gzip_->read(buf, max_len);
+}
 
-    return 0;
+/// @brief 添加chunked结束块中的trailer字段（须在响应体发送结束前调用，在respond()前添加时会在头部中声明）
+void AsyncAbstractResponse::addTrailer(const std::string& name, const std::string& value)
+{
+    if (state_ == RESPONSE_SETUP) {
+        if (!trailerNames_.empty()) {
+            trailerNames_ += ", ";
+        }
+        trailerNames_ += name;
+    }
+    trailers_ += name;
+    trailers_ += ": ";
+    trailers_ += value;
+    trailers_ += "\r\n";
 }
 
+/// @brief 设置直接写入输出的模板回调（须在发送前调用），值无需构造为字符串，超出剩余空间时下一轮续写
+void AsyncAbstractResponse::setTemplateWriter(AwsTemplateWriter writer)
+{
+    if (state_ != RESPONSE_SETUP || !templatable_ || !writer) {
+        return;
+    }
+    writer_ = std::move(writer);
+    // 无法预编译的数据源仍逐块扫描，将输出收集为字符串后替换
+    callback_ = [this](const std::string& name) {
+        std::string value;
+        AsyncTemplateWriter out(value);
+        writer_(name, out);
+        return value;
+    };
+    contentLength_ = 0;
+    sendContentLength_ = 0;
+    chunked_ = true;
+}
 
 /// @brief 从缓存（文件）中读取指定字节的数据到data中
 size_t AsyncAbstractResponse::readDataFromCacheOrContent(uint8_t* data, const size_t len)
 {
-    const size_t readFromCache = std::min(len, cache_.size());
+    const size_t readFromCache = std::min(len, cache_.size() - cacheHead_);
     if (readFromCache) {
-        memcpy(data, cache_.data(), readFromCache);
-        cache_.erase(cache_.begin(), cache_.begin() + readFromCache);
+        memcpy(data, cache_.data() + cacheHead_, readFromCache);
+        cacheHead_ += readFromCache;
+        if (cacheHead_ == cache_.size()) {
+            cache_.clear();
+            cacheHead_ = 0;
+        }
     }
     const size_t needFromFile = len - readFromCache;
     const size_t readFromContent = fillBuffer(data + readFromCache, needFromFile);
     return readFromCache + readFromContent;
 }
 
-/// @brief 加载及模板处理函数..............需要优化
+/// @brief 跳过数据源中的len字节（默认读出后丢弃，可随机访问的数据源应重写）
+/// @return 实际跳过的字节数
+size_t AsyncAbstractResponse::skipContent(size_t len)
+{
+    uint8_t discard[CONFIG_TEMPLATE_PARAM_NAME_LENGTH + 2];
+    size_t skipped = 0;
+    while (skipped < len) {
+        auto read_len = fillBuffer(discard, std::min(len - skipped, sizeof(discard)));
+        if (read_len == 0 || read_len == RESPONSE_TRY_AGAIN) {
+            break;
+        }
+        skipped += read_len;
+    }
+    return skipped;
+}
+
+/// @brief 按预编译模板输出：字面量直接从数据源读取，占位符替换为回调返回的值
+/// @return 写入的字节数（为0表示模板输出完毕）
+size_t AsyncAbstractResponse::fillBufferFromTemplate(uint8_t* data, size_t len)
+{
+    auto& segments = template_->segments();
+    size_t written = 0;
+    while (written < len && segmentIndex_ < segments.size()) {
+        auto& segment = segments[segmentIndex_];
+        size_t n;
+        if (segment.name.empty()) {
+            if (sourceOffset_ < segment.offset) {   // 跳过占位符及转义字符在源中所占的字节
+                sourceOffset_ += skipContent(segment.offset - sourceOffset_);
+                if (sourceOffset_ < segment.offset) {
+                    segmentIndex_ = segments.size();
+                    break;
+                }
+            }
+            n = fillBuffer(data + written, std::min<size_t>(segment.length - segmentOffset_, len - written));
+            if (n == 0 || n == RESPONSE_TRY_AGAIN) {  // 数据源短于编译时（编译后被修改）
+                segmentIndex_ = segments.size();
+                break;
+            }
+            sourceOffset_ += n;
+            if (segmentOffset_ + n == segment.length) {
+                segmentIndex_++;
+                segmentOffset_ = 0;
+            } else {
+                segmentOffset_ += n;
+            }
+        } else if (writer_) {
+            AsyncTemplateWriter out(data + written, len - written, segmentOffset_);
+            writer_(segment.name, out);
+            n = out.stored();
+            if (out.full()) {
+                segmentOffset_ += n;
+            } else {
+                segmentIndex_++;
+                segmentOffset_ = 0;
+            }
+        } else {
+            if (!valueReady_) {
+                value_ = callback_(segment.name);
+                valueReady_ = true;
+            }
+            n = std::min(value_.length() - segmentOffset_, len - written);
+            memcpy(data + written, value_.data() + segmentOffset_, n);
+            if (segmentOffset_ + n == value_.length()) {
+                segmentIndex_++;
+                segmentOffset_ = 0;
+                valueReady_ = false;
+                std::string().swap(value_);
+            } else {
+                segmentOffset_ += n;
+            }
+        }
+        written += n;
+    }
+    return written;
+}
+
+/// @brief 加载及模板处理函数（数据源无法预编译时逐块扫描占位符）
 size_t AsyncAbstractResponse::fillBufferAndProcessTemplates(uint8_t* data, size_t len)
 {
 // 没有回调函数>>>不处理模板
     if (!callback_) {
         return fillBuffer(data, len);
     }
+    if (template_) {
+        return fillBufferFromTemplate(data, len);
+    }
 
     const size_t originalLen = len;
     len = readDataFromCacheOrContent(data, len);
@@ -180,10 +571,10 @@ size_t AsyncAbstractResponse::fillBufferAndProcessTemplates(uint8_t* data, size_
                 if (pTemplateEnd) {
                     *pTemplateEnd = 0;
                     paramName = std::string(reinterpret_cast<char*>(buf));
-                    cache_.insert(cache_.begin(), pTemplateEnd + 1, buf + (&data[len - 1] - pTemplateStart) + readFromCacheOrContent);
+                    cache_.insert(cache_.begin() + cacheHead_, pTemplateEnd + 1, buf + (&data[len - 1] - pTemplateStart) + readFromCacheOrContent);
                     pTemplateEnd = &data[len - 1];
                 } else { // closing placeholder not found in file data, store found percent symbol as is and advance to the next position
-                    cache_.insert(cache_.begin(), buf + (&data[len - 1] - pTemplateStart), buf + (&data[len - 1] - pTemplateStart) + readFromCacheOrContent);
+                    cache_.insert(cache_.begin() + cacheHead_, buf + (&data[len - 1] - pTemplateStart), buf + (&data[len - 1] - pTemplateStart) + readFromCacheOrContent);
                     ++pTemplateStart;
                 }
             } else {
@@ -201,7 +592,7 @@ size_t AsyncAbstractResponse::fillBufferAndProcessTemplates(uint8_t* data, size_
             // make room for param value
             // 1. move extra data to cache if parameter value is longer than placeholder AND if there is no room to store
             if ((pTemplateEnd + 1 < pTemplateStart + numBytesCopied) && (originalLen - (pTemplateStart + numBytesCopied - pTemplateEnd - 1) < len)) {
-                cache_.insert(cache_.begin(), &data[originalLen - (pTemplateStart + numBytesCopied - pTemplateEnd - 1)], &data[len]);
+                cache_.insert(cache_.begin() + cacheHead_, &data[originalLen - (pTemplateStart + numBytesCopied - pTemplateEnd - 1)], &data[len]);
                 //2. parameter value is longer than placeholder text, push the data after placeholder which not saved into cache further to the end
                 memmove(pTemplateStart + numBytesCopied, pTemplateEnd + 1, &data[originalLen] - pTemplateStart - numBytesCopied);
                 len = originalLen; // fix issue with truncated data, not sure if it has any side effects
@@ -215,7 +606,7 @@ size_t AsyncAbstractResponse::fillBufferAndProcessTemplates(uint8_t* data, size_
             memcpy(pTemplateStart, pvstr, numBytesCopied);
             // If result is longer than buffer, copy the remainder into cache (this could happen only if placeholder text itself did not fit entirely in buffer)
             if (numBytesCopied < pvlen) {
-                cache_.insert(cache_.begin(), pvstr + numBytesCopied, pvstr + pvlen);
+                cache_.insert(cache_.begin() + cacheHead_, pvstr + numBytesCopied, pvstr + pvlen);
             } else if (pTemplateStart + numBytesCopied < pTemplateEnd + 1) { // result is copied fully; if result is shorter than placeholder text...
                 // there is some free room, fill it from cache
                 const size_t roomFreed = pTemplateEnd + 1 - pTemplateStart - numBytesCopied;
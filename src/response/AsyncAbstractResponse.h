@@ -3,32 +3,92 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include "AsyncWebServerResponse.h"
+#include "AsyncTemplate.h"
+#include "AsyncGzipEncoder.h"
+
+#define CONFIG_MAX_RANGES       8       // 一个请求中字节范围个数上限（超出时忽略Range，发送完整内容）
 
 class AsyncWebServerRequest;
+class AsyncClient;
 
 /// @brief 派生自定义响应类型的一个抽象基类：支持动态内容生成、模板替换，并通过缓存机制实现流式、分块发送响应体。
 class AsyncAbstractResponse : public AsyncWebServerResponse {
 public:
     AsyncAbstractResponse(AwsTemplateProcessor cb = nullptr);
     void respond(AsyncWebServerRequest* req);
-    size_t ack(AsyncWebServerRequest* req, size_t len, uint32_t time);
+    void addTrailer(const std::string& name, const std::string& value);
+    void setTemplateWriter(AwsTemplateWriter writer);
+    /// @brief 启用流式gzip压缩（客户端接受gzip且内容类型可压缩时生效，须在发送前调用）
+    /// @param level 压缩级别（1~9），0表示不压缩
+    void setCompression(uint8_t level = CONFIG_GZIP_LEVEL) {
+        if (state_ == RESPONSE_SETUP) {
+            compressible_ = level > 0;
+            gzipLevel_ = level;
+        }
+    }
     bool sourceValid() const {
         return false;
     }
     virtual size_t fillBuffer(uint8_t* buf , size_t max_len ) {
         return 0;
     }
+    /// @brief 获取响应体中自index起可直接引用发送的数据（须在响应销毁前保持不变），不支持时返回nullptr
+    /// @param index 响应体偏移
+    /// @param len 返回可引用的数据长度
+    virtual const uint8_t* contentAt(size_t index, size_t& len) {
+        return nullptr;
+    }
+    virtual size_t skipContent(size_t len);
+    /// @brief 将数据源的读取位置移至position（范围请求时使用），不支持时返回false
+    virtual bool seekContent(size_t position) {
+        return false;
+    }
 protected:
+    /// @brief 发送响应体前打开数据源（HEAD请求不调用），失败时响应以失败结束
+    virtual bool openSource() {
+        return true;
+    }
+    /// @brief 编译数据源为模板（发送响应体前调用），不支持预编译时返回nullptr
+    virtual AsyncTemplate::Ptr compileTemplate() {
+        return nullptr;
+    }
+    virtual size_t writeSource(AsyncClient* client, AsyncResponseSegment& segment, size_t space) override;
+
     AwsTemplateProcessor    callback_;  //模板回调
-private:    
+    AwsTemplateWriter       writer_;    // 直接写入输出的模板回调（优先于callback_）
+    AsyncTemplate::Ptr      template_;  // 预编译模板（为空时逐块扫描占位符）
+    bool                    templatable_;   // 数据源是否可作为模板（如压缩文件不可）
+    bool                    rangeable_;     // 数据源是否支持范围请求（可直接引用或定位）
+    bool                    compressible_;  // 是否可压缩发送（回调、分块响应默认启用）
+private:
+    void    setupCompression(AsyncWebServerRequest* req);
+    size_t  fillBody(uint8_t* buf, size_t max_len);
+    size_t  fillCompressed(uint8_t* buf, size_t max_len);
+    void    applyRanges(AsyncWebServerRequest* req);
+    size_t  writeRange(AsyncClient* client, AsyncResponseSegment& segment, size_t space);
+    size_t  writeChunks(AsyncClient* client, AsyncResponseSegment& segment, size_t space);
     size_t  readDataFromCacheOrContent(uint8_t* data, const size_t len);
     size_t  fillBufferAndProcessTemplates(uint8_t* buf, size_t max_len);
+    size_t  fillBufferFromTemplate(uint8_t* buf, size_t max_len);
 
-    size_t                  headerSent_;// 响应头部已发送长度
-    std::string             header_;    // 存放组装好的响应头部
+    bool                    lastChunk_; // 响应体已结束，待写入chunked结束块
     std::vector<uint8_t>    cache_;     // 响应数据缓存
+    size_t                  cacheHead_; // 缓存中已读取的字节数（读完后整体清空，避免逐次移动数据）
     std::vector<uint8_t>    buffer_;    // 用于临时保存待发送的响应体的缓冲区
+    std::string             trailers_;      // chunked结束块中的trailer字段（已格式化）
+    std::string             trailerNames_;  // 在Trailer头中声明的字段名
+    size_t                  segmentIndex_;  // 当前模板片段
+    size_t                  segmentOffset_; // 当前片段已输出的字节数
+    size_t                  sourceOffset_;  // 已从数据源读取的字节数
+    bool                    valueReady_;    // 当前占位符的值已获取
+    std::string             value_;         // 当前占位符的值
+    uint8_t                 gzipLevel_;     // 压缩级别
+    std::unique_ptr<AsyncGzipEncoder>   gzip_;  // 压缩流（为空表示不压缩）
+    std::vector<uint8_t>    raw_;           // 待压缩的原始数据
+    size_t                  rawLimit_;      // 原始数据的声明长度（为0表示未知）
+    size_t                  rawLength_;     // 已读取的原始数据长度
 };
 
 
@@ -6,11 +6,41 @@
 
 AsyncBasicResponse::AsyncBasicResponse(uint16_t code, const std::string& contentType, const std::string& content)
     : AsyncWebServerResponse(code, contentType)
-    , headerSent_(0)
-    , countentSent_(0)
     , content_(content)
+    , zeroCopy_(false)
 {
-    contentLength_ = content_.length();
+    setBody(content_.c_str(), content_.length());
+}
+
+/// @brief 以静态存储为响应体（不拷贝、不持有），数据须在整个程序运行期间有效
+/// @param content 响应体指针
+/// @param len 响应体长度
+AsyncBasicResponse::AsyncBasicResponse(uint16_t code, const std::string& contentType, const char* content, size_t len)
+    : AsyncWebServerResponse(code, contentType)
+    , zeroCopy_(true)
+{
+    setBody(content, content ? len : 0);
+}
+
+/// @brief 以共享缓冲区为响应体（不拷贝），响应持有引用直至数据全部被确认
+/// @param content 共享的响应体
+AsyncBasicResponse::AsyncBasicResponse(uint16_t code, const std::string& contentType, AwsSharedBuffer content)
+    : AsyncWebServerResponse(code, contentType)
+    , shared_(std::move(content))
+    , zeroCopy_(true)
+{
+    if (shared_) {
+        setBody(shared_->data(), shared_->length());
+    } else {
+        setBody(nullptr, 0);
+    }
+}
+
+/// @brief 设置响应体及相应的默认头部
+void AsyncBasicResponse::setBody(const char* data, size_t len)
+{
+    body_ = data;
+    contentLength_ = len;
     if (contentLength_) {
         if(!contentType_.length()) {
             contentType_ = "text/plain";
@@ -19,7 +49,7 @@ AsyncBasicResponse::AsyncBasicResponse(uint16_t code, const std::string& content
     addHeader("Connection", "close");
 }
 
-/// @brief 将基本响应发送出去
+/// @brief 将基本响应发送出去：响应头与响应体作为两个数据段，在同一轮中聚集写入
 /// @param req
 inline void AsyncBasicResponse::respond(AsyncWebServerRequest* req)
 {
@@ -27,74 +57,15 @@ inline void AsyncBasicResponse::respond(AsyncWebServerRequest* req)
         return;
     }
     state_ = RESPONSE_HEADERS;
-    header_ = assembleHead(req->version_);
-    
+    addSegment(assembleHead(req->version_));
+    if (shared_) {
+        addSegment(std::move(shared_));
+    } else if (zeroCopy_) {
+        addSegment(body_, contentLength_);      // 静态存储在整个程序运行期间有效
+    } else {
+        addSegment(std::move(content_));
+    }
+
     // 立即尝试发送
     ack(req, 0, 0);
 }
-
-
-size_t AsyncBasicResponse::ack(AsyncWebServerRequest *req, size_t len, uint32_t time)
-{
-    ackedLength_ += len;
-    auto* client_ = req->client_;
-    if (!sourceValid()) {
-        state_ = RESPONSE_FAILED;
-        client_->close();
-        return 0;
-    }
-
-    size_t totalSent = 0;
-    size_t space = client_->get_send_buffer_size();
-
-
-    if (state_ == RESPONSE_HEADERS) {
-        auto headerRemaining = header_.length() - headerSent_;
-        if (headerRemaining > 0) {
-            auto toSend = std::min(headerRemaining, space);
-            const char* data = header_.c_str() + headerSent_;
-            size_t sent = client_->add(data, toSend);
-            if (sent) {
-                headerSent_ += sent;
-                totalSent += sent;
-                writtenLength_ += sent;
-            }
-        }
-
-        if (headerSent_ >= header_.length()) {
-            state_ = RESPONSE_CONTENT;
-            space -= totalSent;
-        } else {
-            client_->send();
-            return totalSent;
-        }
-        
-    }
-
-    if (state_ == RESPONSE_CONTENT) {
-        auto contentRemaining = content_.length() - countentSent_;
-        if (contentRemaining > 0 && space) {
-            auto toSend = std::min(contentRemaining, space);
-            const char* data = content_.c_str() + countentSent_;
-            auto sent = client_->add(data, toSend);
-            if (sent) {
-                countentSent_ += sent;
-                sentLength_ += sent;
-                writtenLength_ += sent;
-            }
-        }
-
-        if (countentSent_ >= content_.length()) {
-            state_ = RESPONSE_WAIT_ACK;
-        }
-    }
-
-    if (state_ == RESPONSE_WAIT_ACK) {
-        if (ackedLength_ >= writtenLength_) {
-            state_ = RESPONSE_END;
-        }
-    }
-
-    client_->send();
-    return totalSent;
-} 
@@ -12,17 +12,19 @@ class AsyncWebServerRequest;
 class AsyncBasicResponse : public AsyncWebServerResponse {
 public:
     AsyncBasicResponse(uint16_t code, const std::string& contentType=empty_string, const std::string& content=empty_string);
-    size_t ack(AsyncWebServerRequest* req, size_t len, uint32_t time) override;
+    AsyncBasicResponse(uint16_t code, const std::string& contentType, const char* content, size_t len);
+    AsyncBasicResponse(uint16_t code, const std::string& contentType, AwsSharedBuffer content);
     virtual void respond(AsyncWebServerRequest* req) override;
     inline bool sourceValid() const override {
         return true;
     }
 private:
-    size_t      headerSent_;    // 响应头中已发送的数据
-    size_t      countentSent_;  // 响应体中已发送的数据
-    std::string header_;        // 要发送的响应头部
+    void setBody(const char* data, size_t len);
+
     std::string content_;       // 响应要发送的内容（响应体）：content
+    AwsSharedBuffer shared_;    // 共享响应体（持有引用直至响应被确认后销毁）
+    const char* body_;          // 实际发送的响应体（指向content_、静态存储或shared_）
+    bool        zeroCopy_;      // 响应体是否免拷贝发送（静态存储/共享缓冲区）
 };
 
 #endif // !ASYNCBASICRESPONSE_H_
-
@@ -12,6 +12,8 @@ AsyncCallbackResponse::AsyncCallbackResponse(const std::string& contentType, siz
     }
     contentType_ = contentType;
     filledLength_ = 0;
+    enableDataReady();
+    compressible_ = true;
 }
 
 inline bool AsyncCallbackResponse::sourceValid() const 
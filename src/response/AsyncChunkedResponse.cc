@@ -9,4 +9,6 @@ AsyncChunkedResponse::AsyncChunkedResponse(const std::string &contentType, AwsRe
     sendContentLength_ = false;
     chunked_ = true;
     filledLength_ = 0;
+    enableDataReady();
+    compressible_ = true;
 }
\ No newline at end of file
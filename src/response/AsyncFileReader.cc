@@ -0,0 +1,243 @@
+#include "AsyncFileReader.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+
+#define TAG "AsyncFileReader"
+
+#if CONFIG_FILE_READ_AHEAD_TASK
+/// @brief 预读请求
+struct ReadRequest {
+    AsyncFileReader*    reader;
+    void*               block;
+};
+static QueueHandle_t read_queue = nullptr;
+#endif
+
+AsyncFileReader::~AsyncFileReader()
+{
+    close();
+}
+
+/// @brief 打开文件
+bool AsyncFileReader::open(const char* path)
+{
+    close();
+    fd_ = ::open(path, O_RDONLY);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat st;
+    blockSize_ = CONFIG_FILE_READ_BLOCK;
+    if (fstat(fd_, &st) == 0 && (size_t)st.st_size < blockSize_) {
+        blockSize_ = st.st_size > 0 ? st.st_size : 1;   // 小文件只需一块，按实际大小分配
+    }
+    current_ = 0;
+    position_ = 0;
+    eof_.store(false, std::memory_order_relaxed);
+    failed_.store(false, std::memory_order_relaxed);
+
+#if CONFIG_FILE_READ_AHEAD_TASK
+    if (read_queue == nullptr) {
+        read_queue = xQueueCreate(CONFIG_FILE_READ_QUEUE_SIZE, sizeof(ReadRequest));
+        if (read_queue && xTaskCreate(readTask, "file_read", CONFIG_FILE_READ_TASK_STACK, nullptr, CONFIG_FILE_READ_TASK_PRIORITY, nullptr) != pdPASS) {
+            ESP_LOGE(TAG, "创建预读任务失败");
+            vQueueDelete(read_queue);
+            read_queue = nullptr;
+        }
+    }
+    if (loaded_ == nullptr) {
+        loaded_ = xSemaphoreCreateCounting(UINT8_MAX, 0);
+    }
+#endif
+    return true;
+}
+
+/// @brief 关闭文件并释放缓冲区（等待进行中的预读完成）
+/// 预读任务在置块为就绪之后才释放信号量，须取得每个已提交请求的完成信号，确认预读任务不再访问本对象后才可释放
+void AsyncFileReader::close()
+{
+    for (auto& block : blocks_) {
+        wait(block);
+    }
+    while (pending_) {
+        xSemaphoreTake(loaded_, portMAX_DELAY);
+        pending_--;
+    }
+    for (auto& block : blocks_) {
+        free(block.data);
+        block.data = nullptr;
+        block.length = 0;
+        block.offset = 0;
+        block.state.store(BLOCK_EMPTY, std::memory_order_relaxed);
+    }
+    if (loaded_) {
+        vSemaphoreDelete(loaded_);
+        loaded_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+/// @brief 移动读取位置：向后不足一块时在已加载的数据中跳过，否则丢弃已加载的块，按块对齐重新定位后跳过余下字节
+/// @return 是否定位成功（超出文件末尾时失败）
+bool AsyncFileReader::seek(size_t position)
+{
+    if (fd_ < 0) {
+        return false;
+    }
+    if (position >= position_ && position - position_ < blockSize_) {
+        auto delta = position - position_;
+        return skip(delta) == delta;
+    }
+
+    for (auto& block : blocks_) {
+        wait(block);
+        block.length = 0;
+        block.offset = 0;
+        block.state.store(BLOCK_EMPTY, std::memory_order_relaxed);
+    }
+    auto aligned = position - position % blockSize_;
+    if (lseek(fd_, aligned, SEEK_SET) < 0) {
+        return false;
+    }
+    current_ = 0;
+    position_ = aligned;
+    eof_.store(false, std::memory_order_release);
+    auto delta = position - aligned;
+    return skip(delta) == delta;
+}
+
+/// @brief 预读空闲的块（按文件顺序：先当前块，再下一块）
+/// 未启用预读任务时在TCP任务中同步读取，每次至多加载一块，限制每次确认后阻塞TCP任务的时间
+void AsyncFileReader::prefetch()
+{
+    if (fd_ < 0) {
+        return;
+    }
+#if CONFIG_FILE_READ_AHEAD_TASK
+    while (pending_ && xSemaphoreTake(loaded_, 0) == pdTRUE) {
+        pending_--;     // 取走已完成请求的信号（块就绪后未经wait()直接读取时遗留）
+    }
+#endif
+    for (uint8_t i = 0; i < 2; i++) {
+        auto& block = blocks_[current_ ^ i];
+        if (eof_.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (block.state.load(std::memory_order_acquire) != BLOCK_EMPTY) {
+            continue;
+        }
+#if CONFIG_FILE_READ_AHEAD_TASK
+        if (read_queue && loaded_) {
+            ReadRequest request{this, &block};
+            block.state.store(BLOCK_LOADING, std::memory_order_release);
+            if (xQueueSend(read_queue, &request, 0) == pdTRUE) {
+                pending_++;
+                continue;
+            }
+            block.state.store(BLOCK_EMPTY, std::memory_order_release);  // 队列已满，本次不预读
+        }
+        return;
+#else
+        load(block);
+        return;
+#endif
+    }
+}
+
+/// @brief 读取或跳过len字节（buf为空时跳过）
+/// @return 实际读取的字节数，小于len表示文件已结束
+size_t AsyncFileReader::consume(uint8_t* buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len && fd_ >= 0) {
+        auto& block = blocks_[current_];
+        auto state = block.state.load(std::memory_order_acquire);
+        if (state == BLOCK_LOADING) {
+            wait(block);
+        } else if (state == BLOCK_EMPTY) {
+            load(block);    // 未预读时同步加载
+        }
+        if (block.length == 0) {
+            break;
+        }
+
+        auto n = std::min(block.length - block.offset, len - done);
+        if (buf) {
+            memcpy(buf + done, block.data + block.offset, n);
+        }
+        block.offset += n;
+        done += n;
+        if (block.offset == block.length) {
+            block.state.store(BLOCK_EMPTY, std::memory_order_release);
+            current_ ^= 1;
+        }
+    }
+    position_ += done;
+    return done;
+}
+
+/// @brief 从文件中加载一块数据（文件结束或出错时长度为0，出错时置failed_）
+void AsyncFileReader::load(Block& block)
+{
+    if (block.data == nullptr) {
+        block.data = (uint8_t*)malloc(blockSize_);
+        if (block.data == nullptr) {
+            ESP_LOGE(TAG, "分配读取缓冲区失败");
+            failed_.store(true, std::memory_order_release);
+            eof_.store(true, std::memory_order_release);
+        }
+    }
+    size_t length = 0;
+    if (block.data && !eof_.load(std::memory_order_acquire)) {
+        while (length < blockSize_) {
+            auto n = ::read(fd_, block.data + length, blockSize_ - length);
+            if (n <= 0) {
+                if (n < 0) {
+                    failed_.store(true, std::memory_order_release);
+                }
+                eof_.store(true, std::memory_order_release);
+                break;
+            }
+            length += n;
+        }
+    }
+    block.length = length;
+    block.offset = 0;
+    block.state.store(BLOCK_READY, std::memory_order_release);
+}
+
+/// @brief 等待块的预读完成（每取得一次完成信号，已提交的请求数减一）
+void AsyncFileReader::wait(Block& block)
+{
+    while (block.state.load(std::memory_order_acquire) == BLOCK_LOADING) {
+        xSemaphoreTake(loaded_, portMAX_DELAY);
+        pending_--;
+    }
+}
+
+/// @brief 预读任务：依次加载队列中的块
+void AsyncFileReader::readTask(void* arg)
+{
+#if CONFIG_FILE_READ_AHEAD_TASK
+    ReadRequest request;
+    while (true) {
+        if (xQueueReceive(read_queue, &request, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        // 释放信号量之后不得再访问reader：所属任务取得全部完成信号后即可销毁它
+        auto* loaded = request.reader->loaded_;
+        request.reader->load(*reinterpret_cast<Block*>(request.block));
+        xSemaphoreGive(loaded);
+    }
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef ASYNCFILEREADER_H_
+#define ASYNCFILEREADER_H_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define CONFIG_FILE_READ_BLOCK          2048    // 预读块大小（应为文件系统块大小的整数倍）
+#ifndef CONFIG_FILE_READ_AHEAD_TASK
+#define CONFIG_FILE_READ_AHEAD_TASK     0       // 为1时由后台任务预读，否则在数据发出后于TCP任务中预读（每次至多一块）
+#endif
+#define CONFIG_FILE_READ_TASK_STACK     3072    // 预读任务栈大小
+#define CONFIG_FILE_READ_TASK_PRIORITY  4       // 预读任务优先级
+#define CONFIG_FILE_READ_QUEUE_SIZE     8       // 预读请求队列长度
+
+
+/// @brief 双缓冲预读的文件读取器：以无缓冲read()按块读取，当前块被消费时预读下一块
+class AsyncFileReader {
+public:
+    AsyncFileReader() {}
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader &) = delete;              // 删除拷贝构造
+    AsyncFileReader& operator=(const AsyncFileReader &) = delete;   // 删除拷贝复值
+
+    bool open(const char* path);
+    void close();
+    bool isOpen() const {
+        return fd_ >= 0;
+    }
+    /// @brief 是否读取出错（缓冲区分配失败或read()失败），此时read()返回的字节数不足不表示文件结束
+    bool failed() const {
+        return failed_.load(std::memory_order_acquire);
+    }
+    size_t read(uint8_t* buf, size_t len) {
+        return consume(buf, len);
+    }
+    size_t skip(size_t len) {
+        return consume(nullptr, len);
+    }
+    bool seek(size_t position);
+    void prefetch();
+
+private:
+    enum BlockState : uint8_t {
+        BLOCK_EMPTY,    // 空闲，可加载
+        BLOCK_LOADING,  // 已提交预读任务，加载中
+        BLOCK_READY     // 数据可读（length为0表示文件结束或出错）
+    };
+    struct Block {
+        uint8_t*                data{nullptr};      // 块数据
+        size_t                  length{0};          // 有效数据长度
+        size_t                  offset{0};          // 已消费的字节数
+        std::atomic<uint8_t>    state{BLOCK_EMPTY}; // 块状态
+    };
+
+    size_t  consume(uint8_t* buf, size_t len);
+    void    load(Block& block);
+    void    wait(Block& block);
+
+    static void readTask(void* arg);
+
+    int                 fd_{-1};            // 文件描述符
+    size_t              blockSize_{0};      // 块大小（小文件按文件大小分配）
+    uint8_t             current_{0};        // 当前读取的块
+    size_t              position_{0};       // 下一个读取的字节在文件中的偏移
+    std::atomic<bool>   eof_{false};        // 文件已读完（后续块无需加载）
+    std::atomic<bool>   failed_{false};     // 读取出错
+    Block               blocks_[2];         // 双缓冲
+    SemaphoreHandle_t   loaded_{nullptr};   // 预读任务完成一次加载时释放（计数信号量，每个已提交的预读请求释放一次）
+    uint8_t             pending_{0};        // 已提交但尚未取得完成信号的预读请求数（仅由所属任务修改）
+};
+
+#endif // !ASYNCFILEREADER_H_
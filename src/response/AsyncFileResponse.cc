@@ -1,34 +1,57 @@
 #include "AsyncFileResponse.h"
+#include "../request/AsyncWebServerRequest.h"
 #include "../tools.h"
 
+static const char* const encoding_names[FILE_ENCODING_MAX]      = {"identity", "gzip", "br"};
+static const char* const encoding_suffixes[FILE_ENCODING_MAX]   = {"", ".gz", ".br"};
+
+/// @brief 构造文件响应：原文件不存在时，发送前按请求的Accept-Encoding选择预压缩文件（.br/.gz）
 AsyncFileResponse::AsyncFileResponse(std::string path, std::string contentType, bool download, AwsTemplateProcessor cb)
     : AsyncAbstractResponse(cb)
     , path_(std::move(path))
+    , variants_(0)
+{
+    init(std::move(contentType), download);
+
+    struct stat st;
+    exists_ = stat(path_.c_str(), &st) == 0;
+    if (!exists_ && !download) {
+        variants_ = availableEncodings(path_) & ~(1 << FILE_ENCODING_IDENTITY);
+        exists_ = variants_ != 0;
+        return;
+    }
+    AsyncFileInfo info{0, 0, FILE_ENCODING_IDENTITY};
+    if (exists_) {
+        info.size = st.st_size;
+        info.mtime = st.st_mtime;
+    }
+    setSource(info);
+}
+
+/// @brief 以已知的文件信息构造文件响应（不访问文件系统元数据）
+/// @param path 文件路径（不含.gz/.br后缀）
+/// @param info 文件信息
+AsyncFileResponse::AsyncFileResponse(std::string path, const AsyncFileInfo& info, std::string contentType, AwsTemplateProcessor cb)
+    : AsyncAbstractResponse(cb)
+    , path_(std::move(path))
+    , exists_(true)
+    , variants_(0)
+{
+    init(std::move(contentType), false);
+    setSource(info);
+}
+
+/// @brief 按原文件名设置内容类型及Content-Disposition
+void AsyncFileResponse::init(std::string contentType, bool download)
 {
     code_ = 200;
 
     if (contentType.empty()) {
-        setContentType(path_);
+        contentType_ = contentTypeFor(path_);
     } else {
         contentType_ = std::move(contentType);
     }
 
-    if (!download && !FILE_EXISTS(path_.c_str())) {
-        path_ += ".gz";
-        if (FILE_EXISTS(path_.c_str())) {
-            addHeader("Content-Encoding", "gzip");
-            callback_ = nullptr;
-            sendContentLength_ = true;
-            chunked_ = false;
-        }
-    }
-
-    struct stat st;
-    stat(path_.c_str(), &st);
-    contentLength_ = st.st_size;
-    file_ = fopen(path_.c_str(), "r");
-
-
     std::string value;
     value.reserve(128);
     if (download) {
@@ -43,11 +66,107 @@ AsyncFileResponse::AsyncFileResponse(std::string path, std::string contentType,
     addHeader("Content-Disposition", std::move(value));
 }
 
+/// @brief 确定将被发送的文件（原文件或预压缩文件）
+void AsyncFileResponse::setSource(const AsyncFileInfo& info)
+{
+    if (info.encoding != FILE_ENCODING_IDENTITY) {
+        path_ += encodingSuffix(info.encoding);
+        addHeader("Content-Encoding", encodingName(info.encoding));
+        callback_ = nullptr;
+        templatable_ = false;
+        sendContentLength_ = true;
+        chunked_ = false;
+    }
+
+    info_ = info;
+    contentLength_ = info.size;
+    rangeable_ = true;
+}
+
+/// @brief 发送响应：待协商时先按Accept-Encoding选择预压缩文件，均不可接受时以406响应
+void AsyncFileResponse::respond(AsyncWebServerRequest* req)
+{
+    if (variants_) {
+        addHeader("Vary", "Accept-Encoding");
+        auto* accept = req->hasHeader("Accept-Encoding") ? req->header("Accept-Encoding").c_str() : nullptr;
+        auto encoding = negotiateEncoding(accept, variants_);
+        variants_ = 0;
+        struct stat st;
+        if (encoding < 0) {
+            code_ = 406;
+            contentLength_ = 0;
+            callback_ = nullptr;
+            sendContentLength_ = true;
+            chunked_ = false;
+        } else if (stat((path_ + encodingSuffix(encoding)).c_str(), &st) == 0) {
+            setSource({(size_t)st.st_size, st.st_mtime, (uint8_t)encoding});
+        } else {
+            fail(req->client_);
+            return;
+        }
+    }
+    AsyncAbstractResponse::respond(req);
+}
+
+/// @brief 检查文件的各编码版本（原文件、.gz、.br）是否存在
+/// @return 可用编码的位图（1 << AsyncFileEncoding）
+uint8_t AsyncFileResponse::availableEncodings(const std::string& path)
+{
+    uint8_t available = 0;
+    for (uint8_t encoding = 0; encoding < FILE_ENCODING_MAX; encoding++) {
+        if (FILE_IS_REAL((path + encoding_suffixes[encoding]).c_str())) {
+            available |= 1 << encoding;
+        }
+    }
+    return available;
+}
+
+/// @brief 按Accept-Encoding从可用编码中选择：q值最高者优先，q值相同时优先压缩率高的编码（br > gzip > identity）
+/// @param accept 请求的Accept-Encoding，为nullptr表示请求中没有此头（只接受原文件）
+/// @param available 可用编码的位图（1 << AsyncFileEncoding）
+/// @return 选中的编码，均不可接受时返回-1
+int AsyncFileResponse::negotiateEncoding(const char* accept, uint8_t available)
+{
+    if (accept == nullptr) {
+        accept = "identity";
+    }
+    int best = -1;
+    int bestQuality = 0;
+    for (int encoding = FILE_ENCODING_MAX - 1; encoding >= 0; encoding--) {
+        if (!(available & (1 << encoding))) {
+            continue;
+        }
+        auto quality = encodingQuality(accept, encoding_names[encoding]);
+        if (quality > bestQuality) {
+            best = encoding;
+            bestQuality = quality;
+        }
+    }
+    return best;
+}
+
+const char* AsyncFileResponse::encodingName(uint8_t encoding)
+{
+    return encoding < FILE_ENCODING_MAX ? encoding_names[encoding] : encoding_names[0];
+}
+
+const char* AsyncFileResponse::encodingSuffix(uint8_t encoding)
+{
+    return encoding < FILE_ENCODING_MAX ? encoding_suffixes[encoding] : encoding_suffixes[0];
+}
+
+/// @brief 编译文件模板（压缩文件不作为模板）
+AsyncTemplate::Ptr AsyncFileResponse::compileTemplate()
+{
+    if (!exists_ || !templatable_) {
+        return nullptr;
+    }
+    return AsyncTemplate::fromFile(path_, info_.size, info_.mtime);
+}
+
 AsyncFileResponse::~AsyncFileResponse()
 {
-    auto fd = file_;
-    file_ = nullptr;
-    fd && fclose(fd);
+    reader_.close();
 }
 
 
@@ -61,35 +180,35 @@ constexpr uint32_t const_hash(const char* str) {
     return hash;
 }
 
-void AsyncFileResponse::setContentType(const std::string& path)
+/// @brief 根据文件扩展名获取内容类型
+const char* AsyncFileResponse::contentTypeFor(const std::string& path)
 {
     size_t dot_index = path.find_last_of('.');
     if (dot_index == std::string::npos) {
-        contentType_ = "text_plain";
-        return;
+        return "text_plain";
     }
 
     
     switch (const_hash(path.substr(dot_index).c_str())) {
         case const_hash(".htm") :
-        case const_hash(".html") :  contentType_ = "text/html";                 break;
-        case const_hash(".js"):     contentType_ = "application/javascript";    break;
-        case const_hash(".ico"):    contentType_ = "image/x-icon";              break;
-        case const_hash(".css"):    contentType_ = "text/css";                  break;
-        case const_hash(".json"):   contentType_ = "application/json";          break;
-        case const_hash(".png"):    contentType_ = "image/png";                 break;
-        case const_hash(".gif"):    contentType_ = "image/gif";                 break;
+        case const_hash(".html") :  return "text/html";
+        case const_hash(".js"):     return "application/javascript";
+        case const_hash(".ico"):    return "image/x-icon";
+        case const_hash(".css"):    return "text/css";
+        case const_hash(".json"):   return "application/json";
+        case const_hash(".png"):    return "image/png";
+        case const_hash(".gif"):    return "image/gif";
         case const_hash(".jpg"):
-        case const_hash(".jpeg"):   contentType_ = "image/jpeg";                break;
-        case const_hash(".svg"):    contentType_ = "image/svg+xml";             break;
-        case const_hash(".eot"):    contentType_ = "font/eot";                  break;
-        case const_hash(".woff"):   contentType_ = "font/woff";                 break;
-        case const_hash(".woff2"):  contentType_ = "font/woff2";                break;
-        case const_hash(".ttf"):    contentType_ = "font/ttf";                  break;
-        case const_hash(".xml"):    contentType_ = "text/xml";                  break;
-        case const_hash(".pdf"):    contentType_ = "application/pdf";           break;
-        case const_hash(".zip"):    contentType_ = "application/zip";           break;
-        case const_hash(".gz"):     contentType_ = "application/x-gzip";        break;
-        default:                    contentType_ = "text/plain";                break;
+        case const_hash(".jpeg"):   return "image/jpeg";
+        case const_hash(".svg"):    return "image/svg+xml";
+        case const_hash(".eot"):    return "font/eot";
+        case const_hash(".woff"):   return "font/woff";
+        case const_hash(".woff2"):  return "font/woff2";
+        case const_hash(".ttf"):    return "font/ttf";
+        case const_hash(".xml"):    return "text/xml";
+        case const_hash(".pdf"):    return "application/pdf";
+        case const_hash(".zip"):    return "application/zip";
+        case const_hash(".gz"):     return "application/x-gzip";
+        default:                    return "text/plain";
     }
 }
\ No newline at end of file
@@ -2,24 +2,66 @@
 #define ASYNCFILERESPONSE_H_
 
 #include "AsyncAbstractResponse.h"
+#include "AsyncFileReader.h"
 #include <string>
-#include <stdio.h>
+
+/// @brief 文件的内容编码（预压缩文件以后缀区分）
+enum AsyncFileEncoding : uint8_t {
+    FILE_ENCODING_IDENTITY  = 0,    // 原文件
+    FILE_ENCODING_GZIP      = 1,    // path.gz
+    FILE_ENCODING_BROTLI    = 2,    // path.br
+    FILE_ENCODING_MAX,
+};
+
+/// @brief 已知的文件信息（如来自静态资源清单），构造响应时免去stat()
+struct AsyncFileInfo {
+    size_t  size;       // 将被发送的文件大小
+    time_t  mtime;      // 将被发送的文件修改时间
+    uint8_t encoding;   // 将被发送的文件的内容编码（AsyncFileEncoding）
+};
 
 class AsyncFileResponse : public AsyncAbstractResponse {
 public:
     AsyncFileResponse(std::string path, std::string contentType=empty_string, bool download=false, AwsTemplateProcessor cb=nullptr);
+    AsyncFileResponse(std::string path, const AsyncFileInfo& info, std::string contentType=empty_string, AwsTemplateProcessor cb=nullptr);
     ~AsyncFileResponse();
+    virtual void respond(AsyncWebServerRequest* req) override;
+    /// @brief 文件存在且未发生读取错误
     inline bool sourceValid() const {
-        return file_ != nullptr;
+        return exists_ && !reader_.failed();
     }
     inline virtual size_t fillBuffer(uint8_t* buf, size_t maxLen) override {
-        return fread(buf, sizeof(uint8_t), maxLen, file_);
+        return reader_.read(buf, maxLen);
+    }
+    inline virtual size_t skipContent(size_t len) override {
+        return reader_.skip(len);
+    }
+    inline virtual bool seekContent(size_t position) override {
+        return reader_.seek(position);
+    }
+    static const char* contentTypeFor(const std::string& path);
+    static uint8_t availableEncodings(const std::string& path);
+    static int negotiateEncoding(const char* accept, uint8_t available);
+    static const char* encodingName(uint8_t encoding);
+    static const char* encodingSuffix(uint8_t encoding);
+protected:
+    virtual bool openSource() override {
+        exists_ = reader_.open(path_.c_str());
+        return exists_;
+    }
+    virtual AsyncTemplate::Ptr compileTemplate() override;
+    virtual void prefetch() override {
+        reader_.prefetch();
     }
 private:
-    void setContentType(const std::string& path);
+    void init(std::string contentType, bool download);
+    void setSource(const AsyncFileInfo& info);
 
-    FILE        *file_;
-    std::string path_;
+    AsyncFileReader reader_;    // 预读文件读取器（发送响应体时才打开）
+    std::string     path_;
+    AsyncFileInfo   info_;      // 将被发送的文件信息
+    bool            exists_;    // 文件是否存在
+    uint8_t         variants_;  // 待协商的预压缩文件位图（原文件不存在时），0表示已确定
 };
 
 #endif
\ No newline at end of file
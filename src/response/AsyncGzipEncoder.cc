@@ -0,0 +1,354 @@
+#include "AsyncGzipEncoder.h"
+#include <algorithm>
+#include <string.h>
+
+#define MIN_MATCH       3
+#define MAX_MATCH       258
+#define MIN_LOOKAHEAD   (MAX_MATCH + MIN_MATCH + 1)     // 压缩时当前位置之后至少保留的字节数（可找到最长匹配）
+#define END_OF_BLOCK    256
+
+std::atomic<uint8_t> AsyncGzipEncoder::active_{0};
+
+static const uint16_t max_chains[10] = {0, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+
+/// @brief 按位反转（哈夫曼码按高位在前写入，位流按低位在前）
+static inline uint16_t reverseBits(uint16_t code, uint8_t count)
+{
+    uint16_t result = 0;
+    while (count--) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+/// @brief 固定哈夫曼编码表（RFC 1951 3.2.6），已按位反转
+struct FixedCodes {
+    uint16_t    code[288];
+    uint8_t     length[288];
+
+    FixedCodes() {
+        for (uint16_t symbol = 0; symbol < 288; symbol++) {
+            uint16_t value;
+            uint8_t bits;
+            if (symbol < 144) {
+                value = 0x30 + symbol;
+                bits = 8;
+            } else if (symbol < 256) {
+                value = 0x190 + symbol - 144;
+                bits = 9;
+            } else if (symbol < 280) {
+                value = symbol - 256;
+                bits = 7;
+            } else {
+                value = 0xc0 + symbol - 280;
+                bits = 8;
+            }
+            code[symbol] = reverseBits(value, bits);
+            length[symbol] = bits;
+        }
+    }
+};
+
+static const FixedCodes& fixedCodes()
+{
+    static FixedCodes codes;
+    return codes;
+}
+
+/// @brief CRC32（gzip尾部），按半字节查表
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+/// @brief 三字节哈希
+static inline uint32_t hash3(const uint8_t* p, uint8_t bits)
+{
+    return ((p[0] | (p[1] << 8) | (p[2] << 16)) * 2654435761u) >> (32 - bits);
+}
+
+/// @brief 创建压缩流，进行中的压缩流已达上限时返回nullptr
+/// @param level 压缩级别（1~9）
+AsyncGzipEncoder* AsyncGzipEncoder::create(uint8_t level)
+{
+    if (level == 0) {
+        return nullptr;
+    }
+    if (active_.fetch_add(1) >= CONFIG_GZIP_MAX_STREAMS) {
+        active_--;
+        return nullptr;
+    }
+    return new AsyncGzipEncoder(std::min<uint8_t>(level, 9));
+}
+
+AsyncGzipEncoder::AsyncGzipEncoder(uint8_t level)
+    : windowSize_(1 << CONFIG_GZIP_WINDOW_BITS)
+    , maxChain_(max_chains[level])
+    , niceLength_(level <= 3 ? 32 : level <= 6 ? 128 : MAX_MATCH)
+{
+    window_.resize(windowSize_ * 2);
+    head_.resize(windowSize_);
+    prev_.resize(windowSize_);
+    fixedCodes();
+
+    static const uint8_t header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    out_.assign(header, header + sizeof(header));
+}
+
+AsyncGzipEncoder::~AsyncGzipEncoder()
+{
+    active_--;
+}
+
+/// @brief 压缩数据（输出暂存于内部，未满一个匹配长度的尾部数据留待后续数据或刷新）
+void AsyncGzipEncoder::write(const uint8_t* data, size_t len)
+{
+    if (finished_ || len == 0) {
+        return;
+    }
+    crc_ = crc32Update(crc_, data, len);
+    size_ += len;
+    dirty_ = true;
+    while (len) {
+        slide();
+        auto end = strstart_ + lookahead_;
+        auto n = std::min(len, window_.size() - end);
+        memcpy(&window_[end], data, n);
+        lookahead_ += n;
+        data += n;
+        len -= n;
+        deflate(false);
+    }
+}
+
+/// @brief 同步刷新：已写入的数据全部压缩输出，并以空的存储块对齐到字节（客户端可立即解压）
+void AsyncGzipEncoder::flush()
+{
+    if (finished_ || !dirty_) {
+        return;
+    }
+    deflate(true);
+    if (blockOpen_) {
+        putSymbol(END_OF_BLOCK);
+        blockOpen_ = false;
+    }
+    putBits(0, 3);      // BFINAL=0，BTYPE=00（存储块）
+    alignToByte();
+    static const uint8_t empty[4] = {0x00, 0x00, 0xff, 0xff};
+    out_.insert(out_.end(), empty, empty + sizeof(empty));
+    dirty_ = false;
+}
+
+/// @brief 结束压缩流：输出剩余数据、最后一个块及gzip尾部，并释放窗口内存
+void AsyncGzipEncoder::finish()
+{
+    if (finished_) {
+        return;
+    }
+    deflate(true);
+    if (blockOpen_) {
+        putSymbol(END_OF_BLOCK);
+        blockOpen_ = false;
+    }
+    putBits(1, 1);      // BFINAL=1
+    putBits(1, 2);      // BTYPE=01（固定哈夫曼），空块
+    putSymbol(END_OF_BLOCK);
+    alignToByte();
+    for (int i = 0; i < 4; i++) {
+        out_.push_back(crc_ >> (i * 8));
+    }
+    for (int i = 0; i < 4; i++) {
+        out_.push_back(size_ >> (i * 8));
+    }
+    finished_ = true;
+    std::vector<uint8_t>().swap(window_);
+    std::vector<uint16_t>().swap(head_);
+    std::vector<uint16_t>().swap(prev_);
+}
+
+/// @brief 读取压缩数据
+/// @return 读取的字节数
+size_t AsyncGzipEncoder::read(uint8_t* out, size_t len)
+{
+    auto n = std::min(len, pending());
+    memcpy(out, out_.data() + outHead_, n);
+    outHead_ += n;
+    if (outHead_ == out_.size()) {
+        out_.clear();
+        outHead_ = 0;
+    }
+    return n;
+}
+
+/// @brief 贪婪匹配压缩窗口中的数据
+/// @param flush 为true时压缩全部待压缩数据，否则保留MIN_LOOKAHEAD字节以便找到最长匹配
+void AsyncGzipEncoder::deflate(bool flush)
+{
+    const uint8_t bits = CONFIG_GZIP_WINDOW_BITS;
+    const size_t mask = windowSize_ - 1;
+    auto insert = [&](size_t pos) {
+        auto h = hash3(&window_[pos], bits);
+        prev_[pos & mask] = head_[h];
+        head_[h] = pos;
+    };
+
+    while (lookahead_ >= MIN_LOOKAHEAD || (flush && lookahead_ > 0)) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+        if (lookahead_ >= MIN_MATCH) {
+            size_t cur = head_[hash3(&window_[strstart_], bits)];
+            insert(strstart_);
+            // 窗口外的位置对应的prev_已被新位置覆盖，不再查找
+            size_t limit = strstart_ > windowSize_ ? strstart_ - windowSize_ : 0;
+            size_t maxLength = std::min<size_t>(MAX_MATCH, lookahead_);
+            auto* scan = &window_[strstart_];
+            auto chain = maxChain_;
+            while (cur > limit && chain--) {
+                auto* match = &window_[cur];
+                if (match[bestLength] == scan[bestLength] && match[0] == scan[0]) {
+                    size_t length = 1;
+                    while (length < maxLength && match[length] == scan[length]) {
+                        length++;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = strstart_ - cur;
+                        if (length >= niceLength_ || length == maxLength) {
+                            break;
+                        }
+                    }
+                }
+                cur = prev_[cur & mask];
+            }
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            putMatch(bestLength, bestDistance);
+            auto end = strstart_ + lookahead_;
+            for (size_t i = 1; i < bestLength; i++) {
+                if (strstart_ + i + MIN_MATCH <= end) {
+                    insert(strstart_ + i);
+                }
+            }
+            strstart_ += bestLength;
+            lookahead_ -= bestLength;
+        } else {
+            putLiteral(window_[strstart_]);
+            strstart_++;
+            lookahead_--;
+        }
+    }
+}
+
+/// @brief 当前位置接近窗口末尾时，将后半窗口移至前半，哈希表中过时的位置置空
+void AsyncGzipEncoder::slide()
+{
+    if (strstart_ < window_.size() - MIN_LOOKAHEAD) {
+        return;
+    }
+    memmove(window_.data(), window_.data() + windowSize_, strstart_ + lookahead_ - windowSize_);
+    strstart_ -= windowSize_;
+    for (auto& pos : head_) {
+        pos = pos >= windowSize_ ? pos - windowSize_ : 0;
+    }
+    for (auto& pos : prev_) {
+        pos = pos >= windowSize_ ? pos - windowSize_ : 0;
+    }
+}
+
+/// @brief 需要时开始一个固定哈夫曼块
+void AsyncGzipEncoder::openBlock()
+{
+    if (!blockOpen_) {
+        putBits(0, 1);      // BFINAL=0
+        putBits(1, 2);      // BTYPE=01
+        blockOpen_ = true;
+    }
+}
+
+/// @brief 按低位在前写入count位（count不超过16）
+void AsyncGzipEncoder::putBits(uint32_t value, uint8_t count)
+{
+    bitBuf_ |= value << bitCount_;
+    bitCount_ += count;
+    while (bitCount_ >= 8) {
+        out_.push_back(bitBuf_ & 0xff);
+        bitBuf_ >>= 8;
+        bitCount_ -= 8;
+    }
+}
+
+/// @brief 以0补齐到字节边界
+void AsyncGzipEncoder::alignToByte()
+{
+    if (bitCount_) {
+        out_.push_back(bitBuf_ & 0xff);
+        bitBuf_ = 0;
+        bitCount_ = 0;
+    }
+}
+
+void AsyncGzipEncoder::putSymbol(uint16_t symbol)
+{
+    auto& codes = fixedCodes();
+    putBits(codes.code[symbol], codes.length[symbol]);
+}
+
+void AsyncGzipEncoder::putLiteral(uint8_t value)
+{
+    openBlock();
+    putSymbol(value);
+}
+
+/// @brief 写入一个匹配（长度3~258，距离1~窗口大小）
+void AsyncGzipEncoder::putMatch(size_t length, size_t distance)
+{
+    openBlock();
+
+    // 长度码257~285：长度-3小于8时无附加位，255（长度258）为285，其余每4个码附加位数加1
+    size_t l = length - MIN_MATCH;
+    uint8_t code, extra = 0;
+    size_t base = l;
+    if (l == 255) {
+        code = 28;
+    } else if (l < 8) {
+        code = l;
+    } else {
+        uint8_t nb = 31 - __builtin_clz(l);
+        extra = nb - 2;
+        code = (nb - 1) * 4 + ((l >> extra) & 3);
+        base = (4 | (code & 3)) << extra;
+    }
+    putSymbol(257 + code);
+    if (extra) {
+        putBits(l - base, extra);
+    }
+
+    // 距离码0~29（5位）：距离-1小于4时无附加位，其余每2个码附加位数加1
+    size_t d = distance - 1;
+    extra = 0;
+    base = d;
+    if (d < 4) {
+        code = d;
+    } else {
+        uint8_t nb = 31 - __builtin_clz(d);
+        extra = nb - 1;
+        code = nb * 2 + ((d >> extra) & 1);
+        base = (2 | (code & 1)) << extra;
+    }
+    putBits(reverseBits(code, 5), 5);
+    if (extra) {
+        putBits(d - base, extra);
+    }
+}
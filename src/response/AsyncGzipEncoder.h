@@ -0,0 +1,73 @@
+#ifndef ASYNCGZIPENCODER_H_
+#define ASYNCGZIPENCODER_H_
+
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONFIG_GZIP_LEVEL           4       // 动态响应的默认压缩级别（1~9，越高匹配查找越多、越慢，0表示不压缩）
+#define CONFIG_GZIP_WINDOW_BITS     11      // 压缩窗口大小（2^n字节，9~15），每个压缩流约占用6×2^n字节内存
+#define CONFIG_GZIP_MAX_STREAMS     2       // 同时进行的压缩流个数上限（超出时不压缩）
+#define CONFIG_GZIP_INPUT_BLOCK     512     // 每次从数据源读取的原始数据字节数
+#define CONFIG_GZIP_MIN_LENGTH      256     // 声明长度小于此值的响应不压缩
+
+
+/// @brief 流式gzip压缩器（RFC 1951/1952）：LZ77（有界窗口、哈希链）+ 固定哈夫曼编码
+/// 不生成动态哈夫曼表，以换取较小的内存与代码量；压缩输出暂存于内部队列，由调用者按发送窗口读取
+class AsyncGzipEncoder {
+public:
+    static AsyncGzipEncoder* create(uint8_t level);
+    /// @brief 是否还能创建压缩流
+    static bool available() {
+        return active_.load() < CONFIG_GZIP_MAX_STREAMS;
+    }
+    ~AsyncGzipEncoder();
+
+    void write(const uint8_t* data, size_t len);
+    void flush();
+    void finish();
+    size_t read(uint8_t* out, size_t len);
+    /// @brief 待读取的压缩数据字节数
+    size_t pending() const {
+        return out_.size() - outHead_;
+    }
+    /// @brief 压缩流已结束（finish()之后）
+    bool finished() const {
+        return finished_;
+    }
+
+private:
+    explicit AsyncGzipEncoder(uint8_t level);
+
+    void deflate(bool flush);
+    void slide();
+    void openBlock();
+    void putBits(uint32_t value, uint8_t count);
+    void alignToByte();
+    void putLiteral(uint8_t value);
+    void putMatch(size_t length, size_t distance);
+    void putSymbol(uint16_t symbol);
+
+    std::vector<uint8_t>    window_;    // 滑动窗口（2倍窗口大小：已压缩的历史数据 + 待压缩数据）
+    std::vector<uint16_t>   head_;      // 哈希 -> 最近的位置
+    std::vector<uint16_t>   prev_;      // 位置 -> 同哈希的上一位置（哈希链）
+    std::vector<uint8_t>    out_;       // 待读取的压缩数据
+    size_t      outHead_{0};            // out_中已读取的字节数
+    size_t      windowSize_;            // 窗口大小
+    size_t      strstart_{0};           // 当前压缩位置
+    size_t      lookahead_{0};          // 当前位置之后待压缩的字节数
+    uint16_t    maxChain_;              // 哈希链的最大查找次数
+    uint16_t    niceLength_;            // 达到此长度的匹配不再继续查找
+    uint32_t    bitBuf_{0};             // 未满一字节的输出位
+    uint8_t     bitCount_{0};           // bitBuf_中的位数
+    bool        blockOpen_{false};      // 固定哈夫曼块已开始
+    bool        dirty_{false};          // 上次刷新后有新数据
+    bool        finished_{false};       // 压缩流已结束
+    uint32_t    crc_{0};                // 原始数据的CRC32
+    uint32_t    size_{0};               // 原始数据的字节数（模2^32）
+
+    static std::atomic<uint8_t> active_;    // 进行中的压缩流个数
+};
+
+#endif // !ASYNCGZIPENCODER_H_
@@ -1,12 +1,17 @@
 #include "AsyncProgmemResponse.h"
 
 AsyncProgmemResponse::AsyncProgmemResponse(int code, const std::string &contentType, const uint8_t *content, size_t len, AwsTemplateProcessor callback)
+    : AsyncAbstractResponse(callback)
 {
     code_ = code;
     content_ = content;
     contentType_ = contentType;
-    contentLength_ = len;
+    length_ = len;
     readLength_ = 0;
+    rangeable_ = true;      // 无模板时可直接引用任意范围
+    if (!callback_) {
+        contentLength_ = len;
+    }
 }
 
 inline bool AsyncProgmemResponse::sourceValid() const
@@ -14,9 +19,10 @@ inline bool AsyncProgmemResponse::sourceValid() const
     return true;
 }
 
+/// @brief 拷贝数据至缓冲区（仅模板处理时使用）
 size_t AsyncProgmemResponse::fillBuffer(uint8_t* buf, size_t maxLen)
 {
-    size_t left = contentLength_ - readLength_;
+    size_t left = length_ - readLength_;
     if (left > maxLen) {
         memcpy(buf, content_ + readLength_, maxLen);
         readLength_ += maxLen;
@@ -26,3 +32,18 @@ size_t AsyncProgmemResponse::fillBuffer(uint8_t* buf, size_t maxLen)
     readLength_ += left;
     return left;
 }
+
+/// @brief 内部存储器中的数据在程序运行期间不变，可直接引用发送
+const uint8_t* AsyncProgmemResponse::contentAt(size_t index, size_t& len)
+{
+    len = index < length_ ? length_ - index : 0;
+    return content_ + index;
+}
+
+/// @brief 跳过模板中的占位符（仅移动读取位置）
+size_t AsyncProgmemResponse::skipContent(size_t len)
+{
+    len = std::min(len, length_ - readLength_);
+    readLength_ += len;
+    return len;
+}
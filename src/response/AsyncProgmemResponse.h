@@ -4,15 +4,22 @@
 #include "AsyncAbstractResponse.h"
 #include <string>
 
-/// 以内部存储器为响应
+/// 以内部存储器为响应（无模板时直接引用原始数据发送，不经过缓冲区）
 class AsyncProgmemResponse : public AsyncAbstractResponse {
 public:
     AsyncProgmemResponse(int code, const std::string& contentType, const uint8_t* content, size_t len, AwsTemplateProcessor callback=nullptr);
     inline bool sourceValid() const;
     virtual size_t fillBuffer(uint8_t* buf, size_t maxLen) override;
+    virtual const uint8_t* contentAt(size_t index, size_t& len) override;
+    virtual size_t skipContent(size_t len) override;
+protected:
+    virtual AsyncTemplate::Ptr compileTemplate() override {
+        return AsyncTemplate::fromMemory(content_, length_);
+    }
 private:
     const uint8_t*  content_;
+    size_t          length_;        // 原始数据长度（模板处理时响应长度未知）
     size_t          readLength_;
 };
 
-#endif
\ No newline at end of file
+#endif
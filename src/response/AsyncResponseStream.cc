@@ -0,0 +1,115 @@
+#include "AsyncResponseStream.h"
+#include "../request/AsyncWebServerRequest.h"
+#include <stdio.h>
+#include <algorithm>
+
+AsyncResponseStream::AsyncResponseStream(const std::string& contentType)
+    : AsyncWebServerResponse(200, contentType)
+    , head_(nullptr)
+    , tail_(nullptr)
+    , size_(0)
+{
+}
+
+AsyncResponseStream::~AsyncResponseStream()
+{
+    while (head_) {
+        auto* next = head_->next;
+        AsyncSegmentPool::release(head_);
+        head_ = next;
+    }
+}
+
+/// @brief 在数据段链末尾追加一个空数据段
+AsyncStreamSegment* AsyncResponseStream::append()
+{
+    auto* segment = AsyncSegmentPool::acquire();
+    if (tail_) {
+        tail_->next = segment;
+    } else {
+        head_ = segment;
+    }
+    tail_ = segment;
+    return segment;
+}
+
+/// @brief 写入数据（逐段拷贝，当前段写满后从池中取新段）
+/// @return 写入的字节数，开始发送后返回0
+size_t AsyncResponseStream::write(const uint8_t* data, size_t len)
+{
+    if (state_ != RESPONSE_SETUP) {
+        return 0;
+    }
+    size_t written = 0;
+    while (written < len) {
+        auto* segment = tail_;
+        if (segment == nullptr || segment->length == CONFIG_STREAM_SEGMENT_SIZE) {
+            segment = append();
+        }
+        auto n = std::min(len - written, CONFIG_STREAM_SEGMENT_SIZE - segment->length);
+        memcpy(segment->data + segment->length, data + written, n);
+        segment->length += n;
+        written += n;
+    }
+    size_ += written;
+    return written;
+}
+
+/// @brief 格式化写入：当前段剩余空间足够时直接格式化到数据段中
+size_t AsyncResponseStream::printf(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    auto len = vprintf(format, args);
+    va_end(args);
+    return len;
+}
+
+size_t AsyncResponseStream::vprintf(const char* format, va_list args)
+{
+    if (state_ != RESPONSE_SETUP) {
+        return 0;
+    }
+    auto* segment = tail_;
+    if (segment == nullptr || segment->length == CONFIG_STREAM_SEGMENT_SIZE) {
+        segment = append();
+    }
+    auto space = CONFIG_STREAM_SEGMENT_SIZE - segment->length;
+
+    va_list copy;
+    va_copy(copy, args);
+    auto len = vsnprintf((char*)segment->data + segment->length, space, format, copy);
+    va_end(copy);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < space) {
+        segment->length += len;
+        size_ += len;
+        return len;
+    }
+
+    // 跨段：格式化到临时缓冲区后逐段写入
+    std::string tmp(len, '\0');
+    vsnprintf(&tmp[0], len + 1, format, args);
+    return write((const uint8_t*)tmp.data(), len);
+}
+
+/// @brief 开始发送：内容已全部写入，长度已知；各数据段依次转交为响应数据段
+void AsyncResponseStream::respond(AsyncWebServerRequest* req)
+{
+    if (state_ != RESPONSE_SETUP) {
+        return;
+    }
+    contentLength_ = size_;
+    addHeader("Connection", "close");
+    addSegment(assembleHead(req->version_));
+    while (head_) {
+        auto* next = head_->next;
+        addSegment(head_);
+        head_ = next;
+    }
+    tail_ = nullptr;
+    state_ = RESPONSE_HEADERS;
+    ack(req, 0, 0);
+}
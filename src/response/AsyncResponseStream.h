@@ -0,0 +1,48 @@
+#ifndef ASYNCRESPONSESTREAM_H_
+#define ASYNCRESPONSESTREAM_H_
+
+#include "AsyncWebServerResponse.h"
+#include "AsyncSegmentPool.h"
+#include <string>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+
+/// @brief 流式响应：处理器逐步写入（printf/write），数据保存于数据段链中而非一整块连续内存
+/// 发送时各数据段作为响应数据段直接引用发送（免拷贝），被客户端确认后立即归还数据段池
+/// 须在req->send()之前写完全部内容，发送后写入的数据被忽略
+class AsyncResponseStream : public AsyncWebServerResponse {
+public:
+    AsyncResponseStream(const std::string& contentType);
+    ~AsyncResponseStream();
+    virtual void respond(AsyncWebServerRequest* req) override;
+    inline bool sourceValid() const override {
+        return state_ < RESPONSE_FAILED;
+    }
+
+    size_t write(const uint8_t* data, size_t len);
+    size_t write(uint8_t c) {
+        return write(&c, 1);
+    }
+    size_t print(const char* str) {
+        return write((const uint8_t*)str, strlen(str));
+    }
+    size_t print(const std::string& str) {
+        return write((const uint8_t*)str.data(), str.length());
+    }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t vprintf(const char* format, va_list args);
+    /// @brief 已写入的字节数
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    AsyncStreamSegment* append();
+
+    AsyncStreamSegment* head_;              // 首个数据段（发送时转交给响应数据段）
+    AsyncStreamSegment* tail_;              // 写入中的数据段
+    size_t              size_;              // 已写入的字节数
+};
+
+#endif // !ASYNCRESPONSESTREAM_H_
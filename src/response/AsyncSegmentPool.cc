@@ -0,0 +1,41 @@
+#include "AsyncSegmentPool.h"
+
+AsyncStreamSegment* AsyncSegmentPool::free_ = nullptr;
+size_t AsyncSegmentPool::count_ = 0;
+portMUX_TYPE AsyncSegmentPool::lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+/// @brief 从池中取出一个空数据段，池为空时新分配
+AsyncStreamSegment* AsyncSegmentPool::acquire()
+{
+    portENTER_CRITICAL(&lock_);
+    auto* segment = free_;
+    if (segment) {
+        free_ = segment->next;
+        count_--;
+    }
+    portEXIT_CRITICAL(&lock_);
+
+    if (segment == nullptr) {
+        segment = new AsyncStreamSegment;
+    }
+    segment->next = nullptr;
+    segment->length = 0;
+    return segment;
+}
+
+/// @brief 归还数据段，池中空闲段已达上限时直接释放
+void AsyncSegmentPool::release(AsyncStreamSegment* segment)
+{
+    portENTER_CRITICAL(&lock_);
+    bool pooled = count_ < CONFIG_STREAM_POOL_SIZE;
+    if (pooled) {
+        segment->next = free_;
+        free_ = segment;
+        count_++;
+    }
+    portEXIT_CRITICAL(&lock_);
+
+    if (!pooled) {
+        delete segment;
+    }
+}
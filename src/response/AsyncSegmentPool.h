@@ -0,0 +1,30 @@
+#ifndef ASYNCSEGMENTPOOL_H_
+#define ASYNCSEGMENTPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+#define CONFIG_STREAM_SEGMENT_SIZE      1024    // 流式响应每个数据段的容量
+#define CONFIG_STREAM_POOL_SIZE         8       // 池中保留的空闲数据段个数上限（超出时释放）
+
+
+/// @brief 流式响应的数据段（固定大小，来自数据段池）
+struct AsyncStreamSegment {
+    AsyncStreamSegment* next;                               // 下一个数据段
+    size_t              length;                             // 已写入的字节数
+    uint8_t             data[CONFIG_STREAM_SEGMENT_SIZE];   // 数据
+};
+
+/// @brief 固定大小数据段的全局空闲池（链表与计数由临界区保护，可在多个任务中使用）
+class AsyncSegmentPool {
+public:
+    static AsyncStreamSegment* acquire();
+    static void release(AsyncStreamSegment* segment);
+private:
+    static AsyncStreamSegment*  free_;      // 空闲数据段链表
+    static size_t               count_;     // 空闲数据段个数
+    static portMUX_TYPE         lock_;      // 保护free_与count_（临界区内只做指针操作，分配与释放在临界区外）
+};
+
+#endif // !ASYNCSEGMENTPOOL_H_
@@ -0,0 +1,228 @@
+#include "AsyncTemplate.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#define TEMPLATE_READ_BLOCK     512     // 编译文件模板时每次读取的字节数
+
+/// @brief 写入数据
+/// @return 已处理（写入或丢弃）的字节数，小于len表示空间已满
+size_t AsyncTemplateWriter::write(const void* data, size_t len)
+{
+    if (sink_) {
+        sink_->append((const char*)data, len);
+        return len;
+    }
+
+    auto* src = (const uint8_t*)data;
+    size_t left = len;
+    if (position_ < skip_) {
+        auto drop = std::min(skip_ - position_, left);
+        position_ += drop;
+        src += drop;
+        left -= drop;
+    }
+    auto copy = std::min(left, len_ - stored_);
+    memcpy(buf_ + stored_, src, copy);
+    stored_ += copy;
+    position_ += copy;
+    if (copy < left) {
+        full_ = true;
+    }
+    return len - (left - copy);
+}
+
+/// @brief 格式化写入（结果不超过64字节时不分配内存）
+size_t AsyncTemplateWriter::printf(const char* format, ...)
+{
+    char temp[64];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(temp, sizeof(temp), format, args);
+    va_end(args);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < sizeof(temp)) {
+        return write(temp, len);
+    }
+
+    std::string buffer(len + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&buffer[0], buffer.size(), format, args);
+    va_end(args);
+    return write(buffer.data(), len);
+}
+
+/// @brief 跳过len字节不生成（仅限已输出的部分，回调可据此从resumeOffset()处继续生成）
+void AsyncTemplateWriter::advance(size_t len)
+{
+    if (position_ < skip_) {
+        position_ += std::min(len, skip_ - position_);
+    }
+}
+
+
+std::vector<AsyncTemplate::CacheEntry> AsyncTemplate::cache_;
+uint32_t AsyncTemplate::useCount_ = 0;
+
+/// @brief 模板编译器：可分块输入，占位符允许跨块
+class AsyncTemplate::Compiler {
+public:
+    explicit Compiler(std::vector<AsyncTemplateSegment>& segments)
+        : segments_(segments)
+    {}
+
+    /// @brief 输入一块模板源数据
+    /// @param base 本块在模板源中的偏移
+    void feed(const uint8_t* data, size_t len, uint32_t base)
+    {
+        size_t i = 0;
+        while (i < len) {
+            if (!inName_) {
+                auto* p = (const uint8_t*)memchr(data + i, CONFIG_TEMPLATE_PLACEHOLDER, len - i);
+                if (p == nullptr) {
+                    return;
+                }
+                i = p - data;
+                inName_ = true;
+                nameStart_ = base + i;
+                name_.clear();
+                i++;
+                continue;
+            }
+
+            auto c = data[i];
+            if (c == CONFIG_TEMPLATE_PLACEHOLDER) {
+                pushLiteral(nameStart_);
+                if (name_.empty()) {
+                    literalStart_ = base + i;       // %%：跳过第一个%，第二个%作为字面量起点
+                } else {
+                    segments_.push_back({nameStart_, base + (uint32_t)i + 1 - nameStart_, name_});
+                    literalStart_ = base + i + 1;
+                }
+                inName_ = false;
+            } else if (name_.length() >= CONFIG_TEMPLATE_PARAM_NAME_LENGTH) {
+                inName_ = false;    // 名称过长，起始的%按普通字符处理（名称中不含%，无需回溯）
+            } else {
+                name_.push_back((char)c);
+            }
+            i++;
+        }
+    }
+
+    /// @brief 输入结束，补齐末尾的字面量
+    void finish(uint32_t total)
+    {
+        pushLiteral(total);
+        segments_.shrink_to_fit();
+    }
+
+private:
+    /// @brief 将[literalStart_, end)作为字面量加入（与前一字面量相邻时合并）
+    void pushLiteral(uint32_t end)
+    {
+        if (end <= literalStart_) {
+            return;
+        }
+        if (!segments_.empty()) {
+            auto& last = segments_.back();
+            if (last.name.empty() && last.offset + last.length == literalStart_) {
+                last.length = end - last.offset;
+                literalStart_ = end;
+                return;
+            }
+        }
+        segments_.push_back({literalStart_, end - literalStart_, std::string()});
+        literalStart_ = end;
+    }
+
+    std::vector<AsyncTemplateSegment>&  segments_;
+    uint32_t        literalStart_{0};   // 当前字面量起始偏移
+    uint32_t        nameStart_{0};      // 当前占位符起始'%'的偏移
+    bool            inName_{false};     // 是否正在读取占位符名
+    std::string     name_{};            // 当前占位符名
+};
+
+
+/// @brief 获取文件模板（修改时间或大小变化时重新编译）
+/// @param path 文件路径
+/// @param size 文件大小
+/// @param mtime 文件修改时间
+AsyncTemplate::Ptr AsyncTemplate::fromFile(const std::string& path, size_t size, time_t mtime)
+{
+    auto tpl = lookup(path, nullptr, size, mtime);
+    if (tpl) {
+        return tpl;
+    }
+
+    auto* file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return nullptr;
+    }
+    auto compiled = std::make_shared<AsyncTemplate>();
+    Compiler compiler(compiled->segments_);
+    std::vector<uint8_t> block(TEMPLATE_READ_BLOCK);
+    uint32_t total = 0;
+    size_t len;
+    while ((len = fread(block.data(), 1, block.size(), file)) > 0) {
+        compiler.feed(block.data(), len, total);
+        total += len;
+    }
+    fclose(file);
+    compiler.finish(total);
+
+    store({path, nullptr, size, mtime, 0, compiled});
+    return compiled;
+}
+
+/// @brief 获取内存模板（数据须在程序运行期间保持不变）
+AsyncTemplate::Ptr AsyncTemplate::fromMemory(const uint8_t* data, size_t len)
+{
+    auto tpl = lookup(empty_string, data, len, 0);
+    if (tpl) {
+        return tpl;
+    }
+
+    auto compiled = std::make_shared<AsyncTemplate>();
+    Compiler compiler(compiled->segments_);
+    compiler.feed(data, len, 0);
+    compiler.finish(len);
+
+    store({empty_string, data, len, 0, 0, compiled});
+    return compiled;
+}
+
+/// @brief 在缓存中查找模板，来源已变化的项会被移除
+AsyncTemplate::Ptr AsyncTemplate::lookup(const std::string& path, const uint8_t* data, size_t size, time_t mtime)
+{
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->data != data || it->path != path) {
+            continue;
+        }
+        if (it->size != size || it->mtime != mtime) {
+            cache_.erase(it);
+            return nullptr;
+        }
+        it->lastUse = ++useCount_;
+        return it->tpl;
+    }
+    return nullptr;
+}
+
+/// @brief 存入缓存，已满时淘汰最久未使用的项
+void AsyncTemplate::store(CacheEntry entry)
+{
+    entry.lastUse = ++useCount_;
+    if (cache_.size() < CONFIG_TEMPLATE_CACHE_SIZE) {
+        cache_.push_back(std::move(entry));
+        return;
+    }
+    auto oldest = cache_.begin();
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->lastUse < oldest->lastUse) {
+            oldest = it;
+        }
+    }
+    *oldest = std::move(entry);
+}
@@ -0,0 +1,104 @@
+#ifndef ASYNCTEMPLATE_H_
+#define ASYNCTEMPLATE_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <time.h>
+#include <string.h>
+#include "AsyncWebServerResponse.h"
+
+#define CONFIG_TEMPLATE_CACHE_SIZE      8       // 缓存的预编译模板个数上限
+
+/// @brief 模板片段：name为空时表示模板源中[offset, offset+length)的字面量，否则为占位符（length为"%name%"所占字节数）
+struct AsyncTemplateSegment {
+    uint32_t    offset;     // 在模板源中的偏移
+    uint32_t    length;     // 在模板源中所占的字节数
+    std::string name;       // 占位符名（字面量时为空）
+};
+
+/// @brief 占位符输出器：模板回调将值直接写入发送缓冲区，超出本轮剩余空间的部分在下一轮续写
+/// 续写时回调会以同一占位符再次调用，已输出的前resumeOffset()字节被自动丢弃（回调的输出须确定）
+class AsyncTemplateWriter {
+public:
+    AsyncTemplateWriter(uint8_t* buf, size_t len, size_t skip)
+        : buf_(buf), len_(len), skip_(skip)
+    {}
+    /// @brief 输出追加至字符串（无空间限制）
+    explicit AsyncTemplateWriter(std::string& sink)
+        : sink_(&sink)
+    {}
+
+    size_t write(const void* data, size_t len);
+    size_t print(const char* str) {
+        return write(str, strlen(str));
+    }
+    size_t print(const std::string& str) {
+        return write(str.data(), str.length());
+    }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void advance(size_t len);
+    /// @brief 本次调用前该占位符已输出的字节数
+    size_t resumeOffset() const {
+        return skip_;
+    }
+    /// @brief 本轮空间已满（还有数据未写入）
+    bool full() const {
+        return full_;
+    }
+    /// @brief 本次调用写入缓冲区的字节数
+    size_t stored() const {
+        return stored_;
+    }
+
+private:
+    uint8_t*        buf_{nullptr};      // 输出缓冲区
+    size_t          len_{0};            // 缓冲区大小
+    size_t          skip_{0};           // 需丢弃的已输出字节数
+    size_t          position_{0};       // 本次调用已产生的字节数（含丢弃的部分）
+    size_t          stored_{0};         // 已写入缓冲区的字节数
+    bool            full_{false};       // 是否有数据因空间不足未写入
+    std::string*    sink_{nullptr};     // 字符串输出目标
+};
+
+/*
+ * 占位符规则：
+ * 1. %name% 中name长度为1~CONFIG_TEMPLATE_PARAM_NAME_LENGTH，超出时起始的%按普通字符处理
+ * 2. %% 转义为单个%
+ * 3. 未闭合的%按普通字符处理
+*/
+
+/// @brief 预编译模板：模板源只解析一次，得到字面量区间与占位符组成的片段列表，按来源缓存复用
+class AsyncTemplate {
+public:
+    using Ptr = std::shared_ptr<const AsyncTemplate>;
+
+    static Ptr fromFile(const std::string& path, size_t size, time_t mtime);
+    static Ptr fromMemory(const uint8_t* data, size_t len);
+
+    const std::vector<AsyncTemplateSegment>& segments() const {
+        return segments_;
+    }
+
+private:
+    class Compiler;
+
+    /// @brief 缓存项（文件以路径+修改时间+大小校验，内存以地址+长度区分）
+    struct CacheEntry {
+        std::string     path;
+        const uint8_t*  data;
+        size_t          size;
+        time_t          mtime;
+        uint32_t        lastUse;
+        Ptr             tpl;
+    };
+    static Ptr lookup(const std::string& path, const uint8_t* data, size_t size, time_t mtime);
+    static void store(CacheEntry entry);
+
+    std::vector<AsyncTemplateSegment>   segments_;  // 按源顺序排列的片段
+
+    static std::vector<CacheEntry>      cache_;     // 模板缓存（近似LRU淘汰）
+    static uint32_t                     useCount_;  // 访问计数，用于淘汰最久未使用项
+};
+
+#endif // !ASYNCTEMPLATE_H_
@@ -1,8 +1,11 @@
 #include "AsyncWebServerResponse.h"
 #include "../header/AsyncWebHeader.h"
 #include "../header/DefaultHeaders.h"
+#include "../header/DateHeader.h"
 #include "../request/AsyncWebServerRequest.h"
+#include "AsyncSegmentPool.h"
 #include "AsyncClient.h"
+#include <algorithm>
 
 const char * WS_STR_CONNECTION = "Connection";
 const char * WS_STR_UPGRADE = "Upgrade";
@@ -16,6 +19,8 @@ const char * WS_STR_UUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 AsyncWebServerResponse::AsyncWebServerResponse(uint16_t code, const std::string& contentType)
     : sendContentLength_(true)
     , chunked_(false)
+    , corked_(false)
+    , acceptRanges_(false)
     , code_(code)
     , contentLength_(0)
     , headLength_(0)
@@ -25,6 +30,9 @@ AsyncWebServerResponse::AsyncWebServerResponse(uint16_t code, const std::string&
     , state_(RESPONSE_SETUP)
     , contentType_(contentType)
     , headers_(LinkedList<AsyncWebHeader*>([](AsyncWebHeader* h){ delete h; }))
+    , cursor_(0)
+    , released_(0)
+    , releasedLength_(0)
 {
     for (auto header : DefaultHeaders::Instance()) {
         headers_.add(new AsyncWebHeader(header->name(), header->value()));
@@ -33,15 +41,236 @@ AsyncWebServerResponse::AsyncWebServerResponse(uint16_t code, const std::string&
 
 AsyncWebServerResponse::~AsyncWebServerResponse()
 {
+    if (ready_) {
+        // 等待其他任务中正在进行的填充结束，此后通知不再访问本响应
+        xSemaphoreTake(ready_->lock, portMAX_DELAY);
+        ready_->response = nullptr;
+        ready_->req = nullptr;
+        xSemaphoreGive(ready_->lock);
+    }
+    for (auto i = released_; i < segments_.size(); i++) {
+        releaseSegment(segments_[i]);
+    }
     headers_.free();
 }
 
+/// @brief 追加一个引用外部内存的数据段（须在响应销毁前保持不变）
+void AsyncWebServerResponse::addSegment(const char* data, size_t len)
+{
+    if (len) {
+        segments_.push_back({AsyncResponseSegment::SEGMENT_VIEW, false, (const uint8_t*)data, len, 0, 0, nullptr, nullptr});
+    }
+}
+
+/// @brief 追加一个共享缓冲区数据段（持有引用直至被确认）
+void AsyncWebServerResponse::addSegment(AwsSharedBuffer buffer)
+{
+    if (buffer && buffer->length()) {
+        auto* data = (const uint8_t*)buffer->data();
+        auto len = buffer->length();
+        segments_.push_back({AsyncResponseSegment::SEGMENT_SHARED, false, data, len, 0, 0, std::move(buffer), nullptr});
+    }
+}
+
+/// @brief 追加一个由响应持有的字符串数据段（转为共享缓冲区，发送时无需拷贝）
+void AsyncWebServerResponse::addSegment(std::string data)
+{
+    if (data.length()) {
+        addSegment(std::make_shared<const std::string>(std::move(data)));
+    }
+}
+
+/// @brief 追加一个数据段池中的数据段（转移所有权，被确认后归还）
+void AsyncWebServerResponse::addSegment(AsyncStreamSegment* segment)
+{
+    if (segment->length == 0) {
+        AsyncSegmentPool::release(segment);
+        return;
+    }
+    segments_.push_back({AsyncResponseSegment::SEGMENT_POOLED, false, segment->data, segment->length, 0, 0, nullptr, segment});
+}
+
+/// @brief 追加一个由writeSource()生成的数据段
+/// @param offset 在数据源中的起始偏移
+/// @param length 范围长度（0表示至数据源结束）
+void AsyncWebServerResponse::addSource(size_t offset, size_t length)
+{
+    segments_.push_back({AsyncResponseSegment::SEGMENT_SOURCE, false, nullptr, length, offset, 0, nullptr, nullptr});
+}
+
+/// @brief 处理确认并继续发送：释放已被确认的数据段，再依次从各数据段写入发送队列直至窗口用尽，本轮结束时统一发出一次
+size_t AsyncWebServerResponse::ack(AsyncWebServerRequest* req, size_t len, uint32_t time)
+{
+    auto* client = req->client_;
+    if (!sourceValid()) {
+        fail(client);
+        return 0;
+    }
+
+    ackedLength_ += len;
+    releaseSegments();
+
+    // HEAD请求只发送首个数据段（响应头），响应体数据段不写入、不生成
+    auto count = req->method_ == HTTP_HEAD ? std::min<size_t>(segments_.size(), 1) : segments_.size();
+    size_t sent_bytes = 0;
+    auto space = client->get_send_buffer_size();
+    while (state_ < RESPONSE_WAIT_ACK && space > 0 && cursor_ < count) {
+        auto& segment = segments_[cursor_];
+        size_t sent;
+        if (segment.type == AsyncResponseSegment::SEGMENT_SOURCE) {
+            sent = writeSource(client, segment, space);
+        } else {
+            // 内存数据段在被确认前不会释放，直接引用发送
+            sent = client->add((const char*)segment.data + segment.written, std::min(segment.length - segment.written, space), 0);
+            segment.done = segment.written + sent >= segment.length;
+        }
+        segment.written += sent;
+        writtenLength_ += sent;
+        sent_bytes += sent;
+        space -= std::min(sent, space);
+        if (!segment.done) {
+            break;      // 发送窗口已满或数据源暂无数据
+        }
+        cursor_++;
+        if (state_ == RESPONSE_HEADERS) {
+            state_ = RESPONSE_CONTENT;  // 首个数据段为响应头，响应体与其合并为同一报文段
+        }
+    }
+    if (state_ == RESPONSE_FAILED) {
+        return sent_bytes;      // 数据源出错，连接已中止
+    }
+    if (state_ < RESPONSE_WAIT_ACK && cursor_ >= count) {
+        state_ = RESPONSE_WAIT_ACK;
+    }
+
+    if (state_ == RESPONSE_WAIT_ACK && ackedLength_ >= writtenLength_) {
+        state_ = RESPONSE_END;
+        if (!chunked_ && !sendContentLength_) {
+            client->close();    // 无长度、非分块的响应以关闭连接表示结束
+            return sent_bytes;
+        }
+    }
+
+    flush(client);
+    if (state_ == RESPONSE_CONTENT) {
+        prefetch();
+    }
+    return sent_bytes;
+}
+
+/// @brief 释放已被客户端完全确认的数据段
+void AsyncWebServerResponse::releaseSegments()
+{
+    while (released_ < cursor_) {
+        auto& segment = segments_[released_];
+        if (releasedLength_ + segment.written > ackedLength_) {
+            break;
+        }
+        releasedLength_ += segment.written;
+        releaseSegment(segment);
+        released_++;
+    }
+}
+
+void AsyncWebServerResponse::releaseSegment(AsyncResponseSegment& segment)
+{
+    segment.shared.reset();
+    if (segment.pooled) {
+        AsyncSegmentPool::release(segment.pooled);
+        segment.pooled = nullptr;
+    }
+}
+
+AsyncDataReadySignal::AsyncDataReadySignal()
+    : lock(xSemaphoreCreateMutex())
+{
+}
+
+AsyncDataReadySignal::~AsyncDataReadySignal()
+{
+    if (lock) {
+        vSemaphoreDelete(lock);
+    }
+}
+
+/// @brief 启用数据就绪通知（由数据异步产生的响应在构造时调用）
+void AsyncWebServerResponse::enableDataReady()
+{
+    ready_ = std::make_shared<AsyncDataReadySignal>();
+    if (ready_->lock == nullptr) {
+        ready_.reset();     // 不支持通知，由确认与轮询驱动
+        return;
+    }
+    ready_->response = this;
+}
+
+bool AsyncWebServerResponse::acknowledge(AsyncWebServerRequest* req, size_t len, uint32_t time)
+{
+    if (!ready_) {
+        if (finished()) {
+            return true;
+        }
+        ack(req, len, time);
+        return false;
+    }
+    xSemaphoreTake(ready_->lock, portMAX_DELAY);
+    ready_->req = req;
+    auto done = finished();
+    if (!done) {
+        ack(req, len, time);
+    }
+    unlock(ready_.get());
+    return done;
+}
+
+/// @brief 在调用者的任务中立即重新填充；锁被占用（TCP任务正在处理或其他任务正在填充）时只记录通知，由持有者补做
+/// 填充经AsyncClient写入发送队列（由其转交TCP/IP线程），因此不能在TCP/IP线程中调用
+void AsyncWebServerResponse::post(const std::shared_ptr<AsyncDataReadySignal>& signal)
+{
+    if (!signal) {
+        return;
+    }
+    signal->pending.store(true);
+    if (xSemaphoreTake(signal->lock, 0) != pdTRUE) {
+        return;
+    }
+    signal->pending.store(false);
+    refill(signal.get());
+    unlock(signal.get());
+}
+
+/// @brief 持有锁时执行：响应仍在发送时立即尝试填充并发送（与轮询回调相同）
+void AsyncWebServerResponse::refill(AsyncDataReadySignal* signal)
+{
+    auto* response = signal->response;
+    auto* req = signal->req;
+    if (response != nullptr && req != nullptr
+            && !response->finished()
+            && req->client_->get_send_buffer_size()) {
+        response->ack(req, 0, 0);
+    }
+}
+
+/// @brief 释放锁；持有期间到达的通知在此补做（释放后再检查一次，避免通知恰在释放前到达而丢失）
+void AsyncWebServerResponse::unlock(AsyncDataReadySignal* signal)
+{
+    while (true) {
+        xSemaphoreGive(signal->lock);
+        if (!signal->pending.load() || xSemaphoreTake(signal->lock, 0) != pdTRUE) {
+            return;
+        }
+        if (signal->pending.exchange(false)) {
+            refill(signal);
+        }
+    }
+}
+
 
 /// @brief 组装响应头部（会添加换行\r\n）
 std::string AsyncWebServerResponse::assembleHead(uint8_t version)
 {
     if (version) {
-        addHeader("Accept-Ranges", "none");
+        addHeader("Accept-Ranges", acceptRanges_ ? "bytes" : "none");
         if (chunked_) {
             addHeader("Transfer-Encoding", "chunked");
         }
@@ -56,6 +285,13 @@ std::string AsyncWebServerResponse::assembleHead(uint8_t version)
     out += responseCodeToString(code_);
     out += "\r\n";
 
+    auto* date = DateHeader::Instance().value();    // 已缓存的日期，无需格式化
+    if (date) {
+        out += "Date: ";
+        out.append(date, HTTP_DATE_LENGTH);
+        out += "\r\n";
+    }
+
     if (sendContentLength_) {
         out += "Content-Length: ";
         out += std::to_string(contentLength_);
@@ -75,6 +311,10 @@ std::string AsyncWebServerResponse::assembleHead(uint8_t version)
         out += "\r\n";
     }
     headers_.free();
+    if (rawHeaders_) {
+        out += *rawHeaders_;
+        rawHeaders_.reset();
+    }
     out += "\r\n";
     headLength_ = out.length();
 
@@ -85,6 +325,32 @@ void AsyncWebServerResponse::addHeader(std::string name, std::string value) {
     headers_.add(new AsyncWebHeader(std::move(name), std::move(value)));
 }
 
+/// @brief 恢复发送，并立即发出暂存的数据
+void AsyncWebServerResponse::uncork(AsyncWebServerRequest* req)
+{
+    corked_ = false;
+    if (req != nullptr && req->client_ != nullptr) {
+        req->client_->send();
+    }
+}
+
+/// @brief 每轮ack结束时调用一次：将本轮暂存的数据合并发出（暂停发送时仅保留于发送队列）
+void AsyncWebServerResponse::flush(AsyncClient* client)
+{
+    if (!corked_) {
+        client->send();
+    }
+}
+
+/// @brief 响应失败：中止连接（而非正常关闭）
+/// 发送队列中可能还有免拷贝引用本响应内存（响应头、VIEW/SHARED/POOLED数据段）的报文段，
+/// 正常关闭时协议栈会在响应释放后继续（重）传它们，中止连接则立即丢弃，不再访问这些内存
+void AsyncWebServerResponse::fail(AsyncClient* client)
+{
+    state_ = RESPONSE_FAILED;
+    client->abort();
+}
+
 void AsyncWebServerResponse::respond(AsyncWebServerRequest* req) {
     state_ = RESPONSE_END;
     req->client_->close();
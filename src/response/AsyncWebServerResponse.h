@@ -2,7 +2,13 @@
 #define ASYNCWEBSERVERRESPONSE_H_
 
 #include <string>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <vector>
 #include "../StringArray.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 #define CONFIG_TEMPLATE_PLACEHOLDER     '%'
 #define CONFIG_TEMPLATE_PARAM_NAME_LENGTH   32
@@ -18,6 +24,7 @@ extern const char * WS_STR_ACCEPT;
 extern const char * WS_STR_UUID;
 
 
+class AsyncClient;
 class AsyncWebServer;
 class AsyncWebServerRequest;
 class AsyncWebServerResponse;
@@ -28,6 +35,8 @@ class AsyncWebHandler;
 class AsyncStaticWebHandler;
 class AsyncCallbackWebHandler;
 class AsyncResponseStream;
+class AsyncTemplateWriter;
+struct AsyncStreamSegment;
 
 enum WebResponseState { // 响应的生命周期状态
     RESPONSE_SETUP,     // 初始化阶段
@@ -40,6 +49,40 @@ enum WebResponseState { // 响应的生命周期状态
 
 using AwsResponseFiller = std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)>;
 using AwsTemplateProcessor = std::function<std::string(const std::string &)>;
+using AwsTemplateWriter = std::function<void(const std::string& name, AsyncTemplateWriter& out)>;  // 将占位符的值直接写入输出
+using AwsSharedBuffer = std::shared_ptr<const std::string>;    // 多个响应共享的只读响应体（引用计数）
+using AwsDataReadyNotifier = std::function<void()>;             // 通知数据已就绪（可在其他任务中调用，响应删除后调用无效）
+
+
+/// @brief 响应数据段：响应（含头部）由依次排列的数据段组成，每轮ack从尽可能多的数据段聚集写满发送窗口
+struct AsyncResponseSegment {
+    enum Type : uint8_t {
+        SEGMENT_VIEW,       // 外部内存（须在响应销毁前保持不变），免拷贝
+        SEGMENT_SHARED,     // 共享缓冲区（持有引用直至被确认），免拷贝
+        SEGMENT_POOLED,     // 数据段池中的数据段（被确认后归还），免拷贝
+        SEGMENT_SOURCE,     // 由响应的writeSource()按窗口生成（文件、回调、模板等）
+    };
+    Type                type;
+    bool                done;       // 已全部写入发送队列
+    const uint8_t*      data;       // 数据（SOURCE为nullptr）
+    size_t              length;     // 数据长度（SOURCE为数据源中的范围长度，0表示至数据源结束）
+    size_t              offset;     // SOURCE：在数据源中的起始偏移
+    size_t              written;    // 已写入发送队列的字节数
+    AwsSharedBuffer     shared;     // SHARED：持有的缓冲区
+    AsyncStreamSegment* pooled;     // POOLED：被确认后归还的数据段
+};
+
+/// @brief 数据就绪通知的共享状态：由响应与通知函数共同持有，响应删除后失效
+/// lock保护response、req及响应的发送状态：TCP任务的确认/轮询与其他任务的通知互斥地执行ack()
+struct AsyncDataReadySignal {
+    AsyncDataReadySignal();
+    ~AsyncDataReadySignal();
+
+    AsyncWebServerResponse*     response{nullptr};  // 所属响应（响应删除时清空）
+    AsyncWebServerRequest*      req{nullptr};       // 所属请求（开始发送时设置）
+    SemaphoreHandle_t           lock;               // 访问响应的互斥锁
+    std::atomic<bool>           pending{false};     // 锁被占用期间到达的通知（由持有者释放锁前补做，多次通知合并为一次）
+};
 
 
 class AsyncWebServerResponse {
@@ -62,6 +105,10 @@ public:
         }
     }
     virtual void addHeader(std::string name, std::string value);
+    /// @brief 添加预先格式化的头部块（每行以\r\n结尾），组装时原样追加，多个响应可共享
+    void addRawHeaders(AwsSharedBuffer block) {
+        rawHeaders_ = std::move(block);
+    }
     virtual std::string assembleHead(uint8_t version);
     virtual bool started() const {
         return state_ > RESPONSE_SETUP;
@@ -76,14 +123,52 @@ public:
         return false;
     }
     virtual void respond(AsyncWebServerRequest* req);
-    virtual size_t ack(AsyncWebServerRequest* req, size_t len, uint32_t time) {
-        return 0;
+    virtual size_t ack(AsyncWebServerRequest* req, size_t len, uint32_t time);
+    /// @brief 暂停发送：此后写入的数据仅暂存于发送队列，直至调用uncork()
+    void cork() {
+        corked_ = true;
+    }
+    void uncork(AsyncWebServerRequest* req);
+    /// @brief 在TCP任务中处理确认或轮询（与数据就绪通知互斥）
+    /// @return 响应在此之前是否已结束（已结束时不再ack，可删除）
+    bool acknowledge(AsyncWebServerRequest* req, size_t len, uint32_t time);
+    /// @brief 通知数据源已有新数据：在调用者的任务中立即重新填充，而不必等待下一次确认或轮询
+    /// 可在TCP/IP线程（lwIP回调）以外的任意任务中调用；TCP任务正在处理该响应时，通知合并到它释放锁前的一次填充中
+    /// 仅适用于回调/分块响应，须在响应删除前调用；响应可能先于数据源结束时使用dataReadyNotifier()
+    void notifyDataReady() {
+        post(ready_);
+    }
+    /// @brief 获取可由其他任务长期持有的数据就绪通知函数
+    AwsDataReadyNotifier dataReadyNotifier() const {
+        std::weak_ptr<AsyncDataReadySignal> signal = ready_;
+        return [signal]() { post(signal.lock()); };
     }
 protected:
     const char* responseCodeToString(uint16_t code);
+    void flush(AsyncClient* client);
+    void fail(AsyncClient* client);
+    void enableDataReady();
+    void addSegment(const char* data, size_t len);
+    void addSegment(AwsSharedBuffer buffer);
+    void addSegment(std::string data);
+    void addSegment(AsyncStreamSegment* segment);
+    void addSource(size_t offset = 0, size_t length = 0);
+    /// @brief 向发送队列写入SOURCE数据段中不超过space字节的数据（不立即发送），数据段结束时置segment.done
+    /// @return 写入的字节数（数据源暂无数据时返回0）
+    virtual size_t writeSource(AsyncClient* client, AsyncResponseSegment& segment, size_t space) {
+        segment.done = true;
+        return 0;
+    }
+    /// @brief 本轮数据发出后调用，可在等待确认期间预读后续数据
+    virtual void prefetch() {}
+    static void post(const std::shared_ptr<AsyncDataReadySignal>& signal);
+    static void refill(AsyncDataReadySignal* signal);
+    static void unlock(AsyncDataReadySignal* signal);
 
     bool    sendContentLength_;                 // 是否发送Content-Length头
     bool    chunked_;                           // 是否使用分块传输
+    bool    corked_;                            // 是否暂停发送（仅暂存数据）
+    bool    acceptRanges_;                      // 是否支持范围请求（Accept-Ranges: bytes）
     int16_t code_;                              // 响应状态码
     size_t  contentLength_;                     // 响应内容长度（为0表示未知）
     size_t  headLength_;                        // 已发送的头信息长度
@@ -93,6 +178,15 @@ protected:
     WebResponseState    state_;                 // 当前响应所处的状态
     std::string         contentType_;           // 内容类型
     LinkedList<AsyncWebHeader*>     headers_;   // 所有的响应头
+    AwsSharedBuffer                 rawHeaders_;// 预先格式化的响应头
+    std::shared_ptr<AsyncDataReadySignal>   ready_; // 数据就绪通知（为空表示不支持）
+    std::vector<AsyncResponseSegment>       segments_;  // 依次发送的数据段（首个为响应头）
+    size_t                                  cursor_;    // 写入中的数据段
+    size_t                                  released_;  // 已释放（被确认）的数据段个数
+    size_t                                  releasedLength_;    // 已释放的数据段所含字节数
+private:
+    void releaseSegments();
+    void releaseSegment(AsyncResponseSegment& segment);
 };
 
 #endif // !ASYNCWEBSERVERRESPONSE_H_
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "AsyncWebRewrite.h"
 #include "../request/AsyncWebServerRequest.h"
+#include "../parameter/AsyncWebParameter.h"
+#include "../router/AsyncRouter.h"
 #include <string>
+#include "esp_log.h"
+
+#define TAG "AsyncWebRewrite"
 
 AsyncWebRewrite::AsyncWebRewrite(const char* from, const char* to)
     : from_(from)
@@ -12,4 +17,151 @@ AsyncWebRewrite::AsyncWebRewrite(const char* from, const char* to)
         params_ = to_.substr(index + 1);
         to_ = to_.substr(0, index);
     }
+
+    // 参数在创建时解析一次：name=value&flag
+    size_t start = 0;
+    while (start < params_.length()) {
+        auto end = params_.find('&', start);
+        if (end == std::string::npos) {
+            end = params_.length();
+        }
+        auto equal = params_.find('=', start);
+        if (equal > end) {
+            equal = end;
+        }
+        if (equal > start) {
+            auto* base = params_.c_str();
+            query_.emplace_back(AsyncWebServerRequest::urlDecode(base + start, base + equal),
+                                equal < end ? AsyncWebServerRequest::urlDecode(base + equal + 1, base + end) : std::string());
+        }
+        start = end + 1;
+    }
+
+    size_t captures = 0;
+    size_t pos = 0;
+    while (pos < from_.length()) {
+        uint8_t type;
+        auto param = AsyncRouter::paramLength(from_, pos, type);
+        if (param) {
+            captures++;
+            pos += param;
+            continue;
+        }
+        if (from_[pos] == '*') {
+            captures++;
+        }
+        pos++;
+    }
+    if (captures == 1 && from_.ends_with("*") && from_.find('*') == from_.length() - 1) {
+        kind_ = REWRITE_PREFIX;
+    } else if (captures) {
+        kind_ = REWRITE_PATTERN;
+    }
+    if (captures > CONFIG_REWRITE_MAX_CAPTURES) {
+        ESP_LOGW(TAG, "%s: 捕获个数超过%d，其余部分不捕获", from, CONFIG_REWRITE_MAX_CAPTURES);
+    }
+
+    expand_ = to_.find('$') != std::string::npos;
+    for (const auto& item : query_) {
+        expand_ = expand_ || item.second.find('$') != std::string::npos;
+    }
+}
+
+/// @brief 检查请求能否被本规则重写
+bool AsyncWebRewrite::match(AsyncWebServerRequest* req, AsyncRewriteCaptures& captures) const
+{
+    return capture(req->url_, captures) && filter(req);
+}
+
+/// @brief 匹配整个URL并记录捕获内容
+bool AsyncWebRewrite::capture(const std::string& url, AsyncRewriteCaptures& captures) const
+{
+    captures.count = 0;
+    auto record = [&captures](size_t offset, size_t length) {
+        if (captures.count < CONFIG_REWRITE_MAX_CAPTURES) {
+            captures.spans[captures.count][0] = offset;
+            captures.spans[captures.count][1] = length;
+            captures.count++;
+        }
+    };
+
+    if (kind_ == REWRITE_EXACT) {
+        return url == from_;
+    }
+    if (kind_ == REWRITE_PREFIX) {
+        auto prefix = from_.length() - 1;
+        if (url.compare(0, prefix, from_, 0, prefix) != 0) {
+            return false;
+        }
+        record(prefix, url.length() - prefix);
+        return true;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < from_.length()) {
+        uint8_t type;
+        auto param = AsyncRouter::paramLength(from_, i, type);
+        if (param) {
+            auto start = j;
+            while (j < url.length() && url[j] != '/') {
+                j++;
+            }
+            if (!AsyncRouter::acceptParam(type, url.c_str() + start, j - start)) {
+                return false;
+            }
+            record(start, j - start);
+            i += param;
+            continue;
+        }
+        if (from_[i] == '*') {
+            // *匹配到URL末尾的后缀之前（后缀中不再有捕获）
+            auto suffix = from_.length() - i - 1;
+            if (url.length() - j < suffix || url.compare(url.length() - suffix, suffix, from_, i + 1, suffix) != 0) {
+                return false;
+            }
+            record(j, url.length() - suffix - j);
+            return true;
+        }
+        if (j == url.length() || url[j] != from_[i]) {
+            return false;
+        }
+        i++;
+        j++;
+    }
+    return j == url.length();
+}
+
+/// @brief 重写请求的URL并加入预先解析的参数
+/// @param captures capture()记录的捕获内容（完全匹配的规则没有捕获）
+void AsyncWebRewrite::apply(AsyncWebServerRequest* req, const AsyncRewriteCaptures& captures) const
+{
+    if (!expand_) {
+        req->url_ = to_;
+        for (const auto& item : query_) {
+            req->addParam(new AsyncWebParameter(item.first, item.second));
+        }
+        return;
+    }
+    auto url = std::move(req->url_);
+    req->url_ = expand(to_, url, captures);
+    for (const auto& item : query_) {
+        req->addParam(new AsyncWebParameter(item.first, expand(item.second, url, captures)));
+    }
+}
+
+/// @brief 将format中的$1~$9替换为捕获内容（没有对应捕获时保留原文）
+std::string AsyncWebRewrite::expand(const std::string& format, const std::string& url, const AsyncRewriteCaptures& captures) const
+{
+    std::string out;
+    out.reserve(format.length() + url.length());
+    for (size_t i = 0; i < format.length(); i++) {
+        auto index = i + 1 < format.length() ? format[i + 1] - '1' : -1;
+        if (format[i] == '$' && index >= 0 && index < captures.count) {
+            out.append(url, captures.spans[index][0], captures.spans[index][1]);
+            i++;
+        } else {
+            out.push_back(format[i]);
+        }
+    }
+    return out;
 }
@@ -3,10 +3,36 @@
 
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
 #include "../request/AsyncWebServerRequest.h"
 
+#define CONFIG_REWRITE_MAX_CAPTURES     9       // 重写规则的捕获个数上限（$1~$9）
+
 using ArRequestFilterFunction = std::function<bool(AsyncWebServerRequest* req)>;
 
+/// @brief 重写规则的匹配方式
+enum AsyncRewriteKind : uint8_t {
+    REWRITE_EXACT = 0,      // 完全匹配（服务器以哈希表索引）
+    REWRITE_PREFIX,         // 前缀匹配（from以*结尾，剩余部分为$1）
+    REWRITE_PATTERN,        // 模式匹配（含参数段或带后缀的*，依次捕获为$1、$2...）
+    REWRITE_CUSTOM,         // 自定义匹配（派生类重写match(req)，按注册顺序逐个调用，不捕获）
+};
+
+/// @brief 重写规则的捕获结果（在URL中的位置与长度）
+struct AsyncRewriteCaptures {
+    uint8_t     count{0};
+    uint16_t    spans[CONFIG_REWRITE_MAX_CAPTURES][2];
+};
+
+
+/// @brief URL重写规则
+/*
+ * from语法同路由模式（参数段":name"、"{name}"、"{name:int}"，*匹配任意剩余部分），但须匹配整个URL
+ * to中的$1~$9替换为依次捕获的内容，?之后的参数在创建时解析，重写时直接加入请求参数（参数值中同样可用$n）
+ * 按其他条件匹配的派生类重写match(req)，并在构造函数中将kind_设为REWRITE_CUSTOM，服务器按注册顺序逐个调用它
+*/
 class AsyncWebRewrite {
 public:
     AsyncWebRewrite(const char* from, const char* to);
@@ -16,9 +42,24 @@ public:
         filter_ = fn;
         return *this;
     }
+    /// @brief 命中后是否继续检测注册晚于本规则的重写规则（默认命中即停止）
+    AsyncWebRewrite& setChaining(bool chaining) {
+        chaining_ = chaining;
+        return *this;
+    }
     bool filter(AsyncWebServerRequest* req) const {
         return filter_ == nullptr || filter_(req);
     }
+    /// @brief 是否设置了过滤器（过滤结果可能取决于请求状态，重写结果不缓存）
+    bool hasFilter() const {
+        return filter_ != nullptr;
+    }
+    bool chaining() const {
+        return chaining_;
+    }
+    AsyncRewriteKind kind() const {
+        return kind_;
+    }
     const std::string& from() const {
         return from_;
     }
@@ -28,15 +69,29 @@ public:
     const std::string& params() const {
         return params_;
     }
+    /// @brief 检查请求能否被本规则重写（REWRITE_CUSTOM规则由服务器调用，须自行调用filter()）
     virtual bool match(AsyncWebServerRequest* req) {
-        return from_ == req->url_ && filter(req);
+        AsyncRewriteCaptures captures;
+        return match(req, captures);
     }
+    bool match(AsyncWebServerRequest* req, AsyncRewriteCaptures& captures) const;
+    bool capture(const std::string& url, AsyncRewriteCaptures& captures) const;
+    void apply(AsyncWebServerRequest* req, const AsyncRewriteCaptures& captures) const;
 
 protected:
+    friend class AsyncWebServer;
+
+    std::string expand(const std::string& format, const std::string& url, const AsyncRewriteCaptures& captures) const;
+
     std::string     from_;                  // 原始URL
     std::string     to_;                    // 重定向后URL
     std::string     params_;                // 附加在目标URL后的参数
+    std::vector<std::pair<std::string, std::string>>  query_;   // 预先解析（URL解码）的参数
     ArRequestFilterFunction     filter_;    // 过滤函数
+    AsyncRewriteKind    kind_{REWRITE_EXACT};   // 匹配方式
+    bool            expand_{false};         // to_或参数值中含有$n
+    bool            chaining_{false};       // 命中后继续检测后续规则
+    uint32_t        order_{0};              // 注册序号（由服务器设置）
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,49 @@
+#include "AsyncMountTable.h"
+#include "../handler/AsyncWebHandler.h"
+#include <algorithm>
+
+#define TAG "AsyncMountTable"
+
+/// @brief URL是否位于挂载前缀之下（前缀之后须为URL结尾或'/'，"/static"不匹配"/staticx"）
+bool AsyncMountTable::covers(const std::string& prefix, const std::string& url)
+{
+    return url.starts_with(prefix) && (prefix.empty() || url.length() == prefix.length() || url[prefix.length()] == '/');
+}
+
+/// @brief 添加挂载点（前缀长度相同时按注册序号排列）
+void AsyncMountTable::add(const std::string& prefix, AsyncWebHandler* handler, uint32_t order)
+{
+    auto pos = std::find_if(mounts_.begin(), mounts_.end(), [&prefix, order](const Mount& mount) {
+        return mount.prefix.length() < prefix.length() || (mount.prefix.length() == prefix.length() && mount.order > order);
+    });
+    mounts_.insert(pos, {prefix, handler, order});
+}
+
+/// @brief 删除处理器的挂载点
+bool AsyncMountTable::remove(AsyncWebHandler* handler)
+{
+    auto found = std::find_if(mounts_.begin(), mounts_.end(), [handler](const Mount& mount) {
+        return mount.handler == handler;
+    });
+    if (found == mounts_.end()) {
+        return false;
+    }
+    mounts_.erase(found);
+    return true;
+}
+
+/// @brief 查找前缀最长且可能处理该请求的挂载点，以及与它前缀相同的其余挂载点（如以过滤器区分AP/STA的两个挂载点）
+/// @return 前缀相同的挂载点（按注册顺序），没有时为空
+std::span<const AsyncMountTable::Mount> AsyncMountTable::find(const std::string& url, uint8_t method) const
+{
+    auto first = std::find_if(mounts_.begin(), mounts_.end(), [&url, method](const Mount& mount) {
+        return covers(mount.prefix, url) && mount.handler->mayHandle(url, method);
+    });
+    if (first == mounts_.end()) {
+        return {};
+    }
+    auto last = std::find_if(first, mounts_.end(), [first](const Mount& mount) {
+        return mount.prefix.length() != first->prefix.length();
+    });
+    return {first, last};
+}
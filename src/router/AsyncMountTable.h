@@ -0,0 +1,33 @@
+#ifndef ASYNCMOUNTTABLE_H_
+#define ASYNCMOUNTTABLE_H_
+
+#include <span>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class AsyncWebHandler;
+
+
+/// @brief 静态资源挂载表：按最长前缀为URL选出挂载点（前缀相同的多个挂载点按注册顺序依次检测），只有它们的处理器访问文件系统
+class AsyncMountTable {
+public:
+    struct Mount {
+        std::string         prefix;     // 挂载的URI前缀（已去除末尾的/，根路径为空）
+        AsyncWebHandler*    handler;    // 处理器
+        uint32_t            order;      // 注册序号
+    };
+
+    static bool covers(const std::string& prefix, const std::string& url);
+    void add(const std::string& prefix, AsyncWebHandler* handler, uint32_t order);
+    bool remove(AsyncWebHandler* handler);
+    void clear() {
+        mounts_.clear();
+    }
+    std::span<const Mount> find(const std::string& url, uint8_t method) const;
+
+private:
+    std::vector<Mount>  mounts_;    // 按前缀长度降序排列（长度相同时按注册顺序）
+};
+
+#endif // !ASYNCMOUNTTABLE_H_
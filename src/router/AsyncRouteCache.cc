@@ -0,0 +1,46 @@
+#include "AsyncRouteCache.h"
+
+#define TAG "AsyncRouteCache"
+
+static_assert((CONFIG_ROUTE_CACHE_SIZE & (CONFIG_ROUTE_CACHE_SIZE - 1)) == 0, "CONFIG_ROUTE_CACHE_SIZE须为2的幂");
+
+AsyncRouteCache::AsyncRouteCache()
+    : entries_(CONFIG_ROUTE_CACHE_SIZE)
+{
+}
+
+/// @brief 方法与URL的哈希（FNV-1a）
+uint32_t AsyncRouteCache::hash(uint8_t method, const std::string& url)
+{
+    uint32_t h = (2166136261u ^ method) * 16777619u;
+    for (auto c : url) {
+        h = (h ^ (uint8_t)c) * 16777619u;
+    }
+    return h;
+}
+
+/// @brief 查找缓存项（同时统计命中与未命中次数）
+/// @param generation 当前的路由表版本
+/// @return 命中的缓存项，未命中时返回nullptr
+const AsyncRouteCacheEntry* AsyncRouteCache::find(uint32_t hash, uint8_t method, const std::string& url, uint32_t generation)
+{
+    if (entries_.empty()) {
+        return nullptr;
+    }
+    const auto& entry = entries_[hash & (entries_.size() - 1)];
+    if (entry.generation == generation && entry.hash == hash && entry.method == method && entry.url == url) {
+        hits_++;
+        return &entry;
+    }
+    misses_++;
+    return nullptr;
+}
+
+/// @brief 获取哈希对应的缓存项以写入（覆盖原有内容）
+AsyncRouteCacheEntry* AsyncRouteCache::slot(uint32_t hash)
+{
+    if (entries_.empty()) {
+        return nullptr;
+    }
+    return &entries_[hash & (entries_.size() - 1)];
+}
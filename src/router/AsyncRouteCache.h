@@ -0,0 +1,53 @@
+#ifndef ASYNCROUTECACHE_H_
+#define ASYNCROUTECACHE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONFIG_ROUTE_CACHE_SIZE     32      // 路由缓存的项数（2的幂，按哈希直接映射，为0时不缓存）
+
+class AsyncWebHandler;
+
+
+/// @brief 路由缓存项：请求行（方法、URL）对应的重写与处理器绑定结果
+struct AsyncRouteCacheEntry {
+    uint32_t            generation{0};  // 写入时的路由表版本（0表示空项）
+    uint32_t            hash{0};        // 方法与URL的哈希
+    uint8_t             method{0};      // 请求的方法
+    bool                rewritten{false};   // URL被重写
+    std::string         url;            // 请求的URL
+    std::string         target;         // 重写后的URL
+    std::vector<std::pair<std::string, std::string>>    params;     // 重写加入的参数
+    std::vector<std::string>    pathParams;     // 路径参数
+    AsyncWebHandler*    handler{nullptr};   // 绑定的处理器
+};
+
+
+/// @brief 路由缓存：按(方法, URL)的哈希直接映射，一次查找即可得到重写与路由结果
+/// 路由表（处理器、重写规则）变化时服务器递增版本号，旧版本的缓存项自动失效
+class AsyncRouteCache {
+public:
+    AsyncRouteCache();
+
+    static uint32_t hash(uint8_t method, const std::string& url);
+    const AsyncRouteCacheEntry* find(uint32_t hash, uint8_t method, const std::string& url, uint32_t generation);
+    AsyncRouteCacheEntry* slot(uint32_t hash);
+    /// @brief 命中次数
+    uint32_t hits() const {
+        return hits_;
+    }
+    /// @brief 未命中次数
+    uint32_t misses() const {
+        return misses_;
+    }
+
+private:
+    std::vector<AsyncRouteCacheEntry>   entries_;   // 缓存项
+    uint32_t    hits_{0};       // 命中次数
+    uint32_t    misses_{0};     // 未命中次数
+};
+
+#endif // !ASYNCROUTECACHE_H_
@@ -0,0 +1,311 @@
+#include "AsyncRouter.h"
+#include "../handler/AsyncWebHandler.h"
+#include <algorithm>
+#include <string.h>
+
+#define TAG "AsyncRouter"
+
+
+AsyncRouter::AsyncRouter()
+    : root_(new Node())
+{
+}
+
+AsyncRouter::~AsyncRouter()
+{
+    destroy(root_);
+}
+
+/// @brief 模式能否由路由树索引（*至多一个，参数段个数不超过上限）
+bool AsyncRouter::routable(const std::string& pattern)
+{
+    if (pattern.empty()) {
+        return false;
+    }
+    size_t params = 0;
+    size_t pos = 0;
+    while (pos < pattern.length()) {
+        uint8_t type;
+        auto param = paramLength(pattern, pos, type);
+        if (param) {
+            params++;
+            pos += param;
+            continue;
+        }
+        if (pattern[pos] == '*') {
+            if (pattern.find('*', pos + 1) != std::string::npos) {
+                return false;
+            }
+            break;
+        }
+        pos++;
+    }
+    return params <= CONFIG_ROUTER_MAX_PARAMS;
+}
+
+/// @brief 模式中pos处的参数段长度（参数段须占据整个路径段：":name"、"{name}"或"{name:type}"）
+/// @param type 保存参数段的类型（未知类型按ROUTE_PARAM_ANY处理）
+/// @return 参数段长度，pos处不是参数段时返回0
+size_t AsyncRouter::paramLength(const std::string& pattern, size_t pos, uint8_t& type)
+{
+    if (pos == 0 || pattern[pos - 1] != '/') {
+        return 0;
+    }
+    type = ROUTE_PARAM_ANY;
+    if (pattern[pos] == ':') {
+        auto end = pattern.find('/', pos);
+        return (end == std::string::npos ? pattern.length() : end) - pos;
+    }
+    if (pattern[pos] != '{') {
+        return 0;
+    }
+    auto close = pattern.find('}', pos);
+    if (close == std::string::npos || (close + 1 < pattern.length() && pattern[close + 1] != '/')) {
+        return 0;
+    }
+    auto colon = pattern.find(':', pos);
+    if (colon < close && pattern.compare(colon + 1, close - colon - 1, "int") == 0) {
+        type = ROUTE_PARAM_INT;
+    }
+    return close + 1 - pos;
+}
+
+/// @brief 路径段能否作为指定类型的参数
+bool AsyncRouter::acceptParam(uint8_t type, const char* data, size_t len)
+{
+    if (len == 0) {
+        return false;
+    }
+    if (type == ROUTE_PARAM_INT) {
+        for (size_t i = 0; i < len; i++) {
+            if (data[i] < '0' || data[i] > '9') {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief 添加路由（模式须先经routable()检查）
+/// @param pattern URI模式
+/// @param methods 支持的HTTP方法
+/// @param handler 处理器
+/// @param order 注册序号（同一URL命中多个路由时序号小者优先）
+void AsyncRouter::add(const std::string& pattern, uint8_t methods, AsyncWebHandler* handler, uint32_t order)
+{
+    auto* node = root_;
+    node->methods |= methods;
+    size_t pos = 0;
+    auto len = pattern.length();
+    uint8_t type;
+    while (pos < len && pattern[pos] != '*') {
+        auto param = paramLength(pattern, pos, type);
+        if (param) {
+            auto found = std::find_if(node->params.begin(), node->params.end(), [type](Node* child) {
+                return child->type == type;
+            });
+            if (found == node->params.end()) {
+                node->params.push_back(new Node());
+                node->params.back()->type = type;
+                found = node->params.end() - 1;
+            }
+            node = *found;
+            node->methods |= methods;
+            pos += param;
+            continue;
+        }
+        auto next = pos;
+        while (next < len && pattern[next] != '*' && !paramLength(pattern, next, type)) {
+            next++;
+        }
+        node = insertStatic(node, pattern.c_str() + pos, next - pos, methods);
+        pos = next;
+    }
+    if (pos < len) {
+        node->wildcards.push_back({handler, order, methods, pattern.substr(pos + 1)});
+    } else {
+        node->routes.push_back({handler, order, methods, {}});
+    }
+}
+
+/// @brief 在node下插入静态片段，必要时拆分已有节点，沿途各节点记入路由支持的方法
+/// @return 片段结束处的节点
+AsyncRouter::Node* AsyncRouter::insertStatic(Node* node, const char* str, size_t len, uint8_t methods)
+{
+    while (len) {
+        auto found = std::find_if(node->children.begin(), node->children.end(), [str](Node* child) {
+            return child->prefix[0] == str[0];
+        });
+        if (found == node->children.end()) {
+            auto* child = new Node();
+            child->prefix.assign(str, len);
+            child->methods = methods;
+            node->children.push_back(child);
+            return child;
+        }
+
+        auto* child = *found;
+        size_t common = 0;
+        while (common < len && common < child->prefix.length() && child->prefix[common] == str[common]) {
+            common++;
+        }
+        if (common < child->prefix.length()) {
+            auto* middle = new Node();
+            middle->prefix = child->prefix.substr(0, common);
+            middle->methods = child->methods;
+            middle->children.push_back(child);
+            child->prefix.erase(0, common);
+            *found = middle;
+            child = middle;
+        }
+        child->methods |= methods;
+        node = child;
+        str += common;
+        len -= common;
+    }
+    return node;
+}
+
+/// @brief 删除处理器的全部路由
+/// @return 是否删除了路由
+bool AsyncRouter::remove(AsyncWebHandler* handler)
+{
+    bool removed = false;
+    prune(root_, handler, removed);
+    return removed;
+}
+
+/// @brief 删除子树中处理器的路由，并重新计算各节点的方法集合
+uint8_t AsyncRouter::prune(Node* node, AsyncWebHandler* handler, bool& removed)
+{
+    uint8_t methods = 0;
+    for (auto* routes : {&node->routes, &node->wildcards}) {
+        auto end = std::remove_if(routes->begin(), routes->end(), [handler](const Route& route) {
+            return route.handler == handler;
+        });
+        if (end != routes->end()) {
+            removed = true;
+            routes->erase(end, routes->end());
+        }
+        for (const auto& route : *routes) {
+            methods |= route.methods;
+        }
+    }
+    for (auto* child : node->children) {
+        methods |= prune(child, handler, removed);
+    }
+    for (auto* child : node->params) {
+        methods |= prune(child, handler, removed);
+    }
+    node->methods = methods;
+    return methods;
+}
+
+/// @brief 删除全部路由
+void AsyncRouter::clear()
+{
+    destroy(root_);
+    root_ = new Node();
+}
+
+void AsyncRouter::destroy(Node* node)
+{
+    for (auto* child : node->children) {
+        destroy(child);
+    }
+    for (auto* child : node->params) {
+        destroy(child);
+    }
+    delete node;
+}
+
+/// @brief 查找能处理请求的路由
+/// @param req 请求（用于调用处理器的过滤器）
+/// @param url 请求的URL
+/// @param method 请求的方法
+/// @param result 命中时保存处理器、注册序号与路径参数
+/// @return 是否命中
+bool AsyncRouter::match(AsyncWebServerRequest* req, const std::string& url, uint8_t method, AsyncRouteMatch& result) const
+{
+    Walk state;
+    state.req = req;
+    state.url = url.c_str();
+    state.end = url.c_str() + url.length();
+    state.method = method;
+    state.depth = 0;
+    state.result = &result;
+    walk(root_, state.url, state);
+    return result.handler != nullptr;
+}
+
+/// @brief 从node（其前缀已匹配）开始匹配URL的剩余部分pos
+void AsyncRouter::walk(const Node* node, const char* pos, Walk& state)
+{
+    if (!(node->methods & state.method)) {
+        return;
+    }
+    consider(node->wildcards, pos, state);
+    if (pos == state.end || *pos == '/') {
+        consider(node->routes, pos, state);
+    }
+    if (pos == state.end) {
+        return;
+    }
+
+    auto rest = state.end - pos;
+    for (const auto* child : node->children) {
+        if (child->prefix[0] == *pos) {
+            if ((size_t)rest >= child->prefix.length() && memcmp(pos, child->prefix.data(), child->prefix.length()) == 0) {
+                walk(child, pos + child->prefix.length(), state);
+            }
+            break;
+        }
+    }
+
+    if (node->params.empty()) {
+        return;
+    }
+    auto* segment = (const char*)memchr(pos, '/', rest);
+    if (segment == nullptr) {
+        segment = state.end;
+    }
+    for (const auto* child : node->params) {
+        if (!acceptParam(child->type, pos, segment - pos)) {
+            continue;
+        }
+        state.params[state.depth][0] = pos - state.url;
+        state.params[state.depth][1] = segment - pos;
+        state.depth++;
+        walk(child, segment, state);
+        state.depth--;
+    }
+}
+
+/// @brief 检查路由能否处理请求，注册序号小于当前结果时替换
+/// @param pos URL的剩余部分（用于检查通配路由的后缀）
+void AsyncRouter::consider(const std::vector<Route>& routes, const char* pos, Walk& state)
+{
+    auto* result = state.result;
+    for (const auto& route : routes) {
+        if (route.order >= result->order || !(route.methods & state.method)) {
+            continue;
+        }
+        auto suffix = route.suffix.length();
+        if (suffix && ((size_t)(state.end - pos) < suffix || memcmp(state.end - suffix, route.suffix.data(), suffix) != 0)) {
+            continue;
+        }
+        if (route.handler->isRequestHandlerTrivial()) {
+            continue;
+        }
+        if (route.handler->hasFilter()) {
+            result->filtered = true;
+            if (!route.handler->filter(state.req)) {
+                continue;
+            }
+        }
+        result->handler = route.handler;
+        result->order = route.order;
+        result->count = state.depth;
+        memcpy(result->params, state.params, sizeof(state.params[0]) * state.depth);
+    }
+}
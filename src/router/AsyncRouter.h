@@ -0,0 +1,89 @@
+#ifndef ASYNCROUTER_H_
+#define ASYNCROUTER_H_
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONFIG_ROUTER_MAX_PARAMS    8       // 单个路由的路径参数个数上限（超出的路由按注册顺序逐个检测）
+
+class AsyncWebHandler;
+class AsyncWebServerRequest;
+
+/// @brief 参数段的类型
+enum AsyncRouteParamType : uint8_t {
+    ROUTE_PARAM_ANY = 0,    // 任意非空路径段（:name、{name}）
+    ROUTE_PARAM_INT,        // 十进制数字（{name:int}）
+};
+
+
+/// @brief 路由查找结果
+struct AsyncRouteMatch {
+    AsyncWebHandler*    handler{nullptr};                       // 命中的处理器
+    uint32_t            order{UINT32_MAX};                      // 处理器的注册序号
+    uint8_t             count{0};                               // 路径参数个数
+    bool                filtered{false};                        // 查找中调用过处理器的过滤器
+    uint16_t            params[CONFIG_ROUTER_MAX_PARAMS][2];    // 路径参数在URL中的位置与长度
+};
+
+
+/// @brief 压缩前缀树（radix tree）路由表：注册时按URI模式建树，查找时沿URL单次遍历
+/// URI模式：
+/// 1. 静态路径：匹配该路径及其子路径（"/api"匹配"/api"与"/api/..."）
+/// 2. 参数段：匹配一个非空路径段，并作为路径参数捕获（"/user/:id"、"/user/{id}"、"/user/{id:int}"只匹配数字）
+/// 3. 通配：*匹配任意剩余部分，其后的字符为后缀（"/static/*"、"/*.js"、"/img/*.png"）
+/// 同一URL命中多个路由时，注册序号最小且方法、过滤器均通过者胜出（与逐个检测的结果一致）
+class AsyncRouter {
+public:
+    AsyncRouter();
+    ~AsyncRouter();
+    AsyncRouter(const AsyncRouter&) = delete;
+    AsyncRouter& operator=(const AsyncRouter&) = delete;
+
+    static bool routable(const std::string& pattern);
+    static size_t paramLength(const std::string& pattern, size_t pos, uint8_t& type);
+    static bool acceptParam(uint8_t type, const char* data, size_t len);
+    void add(const std::string& pattern, uint8_t methods, AsyncWebHandler* handler, uint32_t order);
+    bool remove(AsyncWebHandler* handler);
+    void clear();
+    bool match(AsyncWebServerRequest* req, const std::string& url, uint8_t method, AsyncRouteMatch& result) const;
+
+private:
+    struct Route {
+        AsyncWebHandler*    handler;    // 处理器
+        uint32_t            order;      // 注册序号
+        uint8_t             methods;    // 支持的HTTP方法
+        std::string         suffix;     // 通配路由要求的URL后缀
+    };
+
+    struct Node {
+        std::string         prefix;         // 静态片段（压缩后的公共前缀）
+        std::vector<Node*>  children;       // 静态子节点（首字符互不相同）
+        std::vector<Node*>  params;         // 参数子节点（各匹配一个非空路径段，类型互不相同）
+        std::vector<Route>  routes;         // 在此结束的路由（URL在此结束或后接'/'时命中）
+        std::vector<Route>  wildcards;      // 在此结束的通配路由（剩余部分以后缀结尾时命中）
+        uint8_t             methods{0};     // 子树中所有路由支持的方法（查找时剪枝）
+        uint8_t             type{ROUTE_PARAM_ANY};  // 参数节点的类型
+    };
+
+    struct Walk {
+        AsyncWebServerRequest*  req;
+        const char*             url;
+        const char*             end;
+        uint8_t                 method;
+        uint8_t                 depth;
+        uint16_t                params[CONFIG_ROUTER_MAX_PARAMS][2];
+        AsyncRouteMatch*        result;
+    };
+
+    static Node* insertStatic(Node* node, const char* str, size_t len, uint8_t methods);
+    static uint8_t prune(Node* node, AsyncWebHandler* handler, bool& removed);
+    static void destroy(Node* node);
+    static void walk(const Node* node, const char* pos, Walk& walk);
+    static void consider(const std::vector<Route>& routes, const char* pos, Walk& walk);
+
+    Node*   root_;      // 根节点（前缀为空）
+};
+
+#endif // !ASYNCROUTER_H_
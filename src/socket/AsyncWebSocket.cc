@@ -45,6 +45,12 @@ bool AsyncWebSocket::canHandle(AsyncWebServerRequest* req)
     return true;
 }
 
+/// @brief 只可能处理绑定URI的GET请求
+bool AsyncWebSocket::mayHandle(const std::string& url, uint8_t method) const
+{
+    return method == HTTP_GET && url == uri_;
+}
+
 /// @brief 处理请求，将协议升级为websocket(发送响应并收到确认后，会生成一个WebsocketClient对象接管连接)
 /// @param req 
 void AsyncWebSocket::handleRequest(AsyncWebServerRequest* req)
@@ -54,13 +60,6 @@ void AsyncWebSocket::handleRequest(AsyncWebServerRequest* req)
         req->send(400); // 返回客户格式错误
         return;
     }
-    // 进行socket客户端认证
-    if (username_ != "" && password_ != "") {
-        if (!req->authenticate(username_.c_str(), password_.c_str())) {
-            return req->requestAuthentication();
-        }
-    }
-
     auto* version = req->getHeader(WS_STR_VERSION);
     if (std::stoi(version->value()) != 13)   {
         // 标准规定Sec-WebSocket-Version必须为13
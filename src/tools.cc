@@ -2,6 +2,11 @@
 #include <string>
 #include <stdio.h>
 #include <sys/stat.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <algorithm>
 
 // 构造空对象需要时间，这里构造一个供整个库使用
 const std::string empty_string = std::string();
@@ -50,4 +55,366 @@ bool strContains(std::string src, std::string find, bool ignoreCase)
         pos++;
     }
     return false;
-}
\ No newline at end of file
+}
+
+/// @brief 将时间格式化为IMF-fixdate（如"Sun, 06 Nov 1994 08:49:37 GMT"），buf至少30字节
+/// @return 写入的字符数（不含结尾'\0'）
+size_t formatHttpDate(time_t t, char* buf)
+{
+    static const char days[] = "SunMonTueWedThuFriSat";
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    auto two = [](char* p, int v) {
+        p[0] = '0' + v / 10;
+        p[1] = '0' + v % 10;
+    };
+    memcpy(buf, days + tm.tm_wday * 3, 3);
+    buf[3] = ',';
+    buf[4] = ' ';
+    two(buf + 5, tm.tm_mday);
+    buf[7] = ' ';
+    memcpy(buf + 8, months + tm.tm_mon * 3, 3);
+    buf[11] = ' ';
+    auto year = tm.tm_year + 1900;
+    two(buf + 12, year / 100);
+    two(buf + 14, year % 100);
+    buf[16] = ' ';
+    two(buf + 17, tm.tm_hour);
+    buf[19] = ':';
+    two(buf + 20, tm.tm_min);
+    buf[22] = ':';
+    two(buf + 23, tm.tm_sec);
+    memcpy(buf + 25, " GMT", 5);
+    return 29;
+}
+
+/// @brief 检查If-None-Match/If-Match等头部中的实体标签列表是否包含etag
+/// @param header 头部值，如 "abc", W/"def" 或 *
+/// @param etag 当前资源的实体标签（含引号，可带W/前缀）
+/// @param weak 是否采用弱比较（忽略W/前缀），If-None-Match须用弱比较，If-Match须用强比较
+bool etagMatches(const char* header, const std::string& etag, bool weak)
+{
+    if (etag.empty()) {
+        return false;
+    }
+    auto* tag = etag.c_str();
+    auto tagWeak = strncmp(tag, "W/", 2) == 0;
+    if (tagWeak) {
+        if (!weak) {
+            return false;
+        }
+        tag += 2;
+    }
+    auto tagLen = strlen(tag);
+
+    auto* p = header;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        if (*p == '*') {
+            return true;
+        }
+        auto itemWeak = strncmp(p, "W/", 2) == 0;
+        if (itemWeak) {
+            p += 2;
+        }
+        if (*p != '"') {
+            break;  // 格式错误
+        }
+        auto* end = strchr(p + 1, '"');
+        if (end == nullptr) {
+            break;
+        }
+        auto len = end - p + 1;
+        if ((weak || !itemWeak) && (size_t)len == tagLen && memcmp(p, tag, len) == 0) {
+            return true;
+        }
+        p = end + 1;
+    }
+    return false;
+}
+
+/// @brief 由公历日期计算自1970-01-01起的天数（不依赖时区设置）
+static int64_t daysFromCivil(int year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = (unsigned)(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + (int64_t)doe - 719468;
+}
+
+/// @brief 读取十进制数字，返回读取的位数
+static int readNumber(const char*& p, int& value, int maxDigits)
+{
+    int n = 0;
+    value = 0;
+    while (n < maxDigits && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        n++;
+    }
+    return n;
+}
+
+/// @brief 读取三个字母的月份缩写，返回1~12，失败时返回0
+static int readMonth(const char*& p)
+{
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    for (int i = 0; i < 12; i++) {
+        if (strncasecmp(p, months + i * 3, 3) == 0) {
+            p += 3;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/// @brief 读取"hh:mm:ss"，返回当天的秒数，失败时返回-1
+static int readTime(const char*& p)
+{
+    int h, m, s;
+    if (readNumber(p, h, 2) != 2 || *p++ != ':'
+        || readNumber(p, m, 2) != 2 || *p++ != ':'
+        || readNumber(p, s, 2) != 2
+        || h > 23 || m > 59 || s > 60) {
+            return -1;
+    }
+    return h * 3600 + m * 60 + s;
+}
+
+/// @brief 解析HTTP日期（RFC 7231 7.1.1.1），接受以下三种格式：
+/// IMF-fixdate "Sun, 06 Nov 1994 08:49:37 GMT"；RFC 850 "Sunday, 06-Nov-94 08:49:37 GMT"；asctime "Sun Nov  6 08:49:37 1994"
+/// @return 自1970-01-01起的秒数（UTC），格式错误时返回-1
+time_t parseHttpDate(const char* str)
+{
+    if (str == nullptr) {
+        return -1;
+    }
+    auto* p = str;
+    while (*p == ' ') {
+        p++;
+    }
+    while (isalpha((unsigned char)*p)) {   // 星期不参与计算
+        p++;
+    }
+
+    int year, month, day, seconds;
+    if (*p == ',') {
+        // IMF-fixdate 或 RFC 850
+        p++;
+        while (*p == ' ') {
+            p++;
+        }
+        if (readNumber(p, day, 2) == 0 || (*p != ' ' && *p != '-')) {
+            return -1;
+        }
+        auto sep = *p++;
+        if ((month = readMonth(p)) == 0 || *p++ != sep) {
+            return -1;
+        }
+        auto digits = readNumber(p, year, 4);
+        if (digits == 2) {
+            year += year < 70 ? 2000 : 1900;   // RFC 850两位年份
+        } else if (digits != 4) {
+            return -1;
+        }
+        if (*p++ != ' ' || (seconds = readTime(p)) < 0) {
+            return -1;
+        }
+    } else if (*p == ' ') {
+        // asctime
+        p++;
+        if ((month = readMonth(p)) == 0 || *p++ != ' ') {
+            return -1;
+        }
+        if (*p == ' ') {
+            p++;
+        }
+        if (readNumber(p, day, 2) == 0 || *p++ != ' ' || (seconds = readTime(p)) < 0
+            || *p++ != ' ' || readNumber(p, year, 4) != 4) {
+                return -1;
+        }
+    } else {
+        return -1;
+    }
+    if (day < 1 || day > 31 || year < 1970) {
+        return -1;
+    }
+    return (time_t)(daysFromCivil(year, month, day) * 86400 + seconds);
+}
+
+/// @brief 检查If-Range的值是否与当前资源一致（一致时才可只发送请求的范围）
+/// @param value If-Range头部值：实体标签（强比较）或HTTP日期（须与Last-Modified完全相同）
+/// @param etag 当前资源的实体标签
+/// @param lastModified 当前资源的修改时间（-1表示未知）
+bool ifRangeMatches(const char* value, const std::string& etag, time_t lastModified)
+{
+    while (*value == ' ') {
+        value++;
+    }
+    if (*value == '"' || strncmp(value, "W/", 2) == 0) {
+        return *value == '"' && etagMatches(value, etag, false);
+    }
+    auto date = parseHttpDate(value);
+    return date != -1 && lastModified != -1 && date == lastModified;
+}
+
+/// @brief 解析Range请求头（RFC 7233），按资源大小换算为有序、不重叠的字节范围
+/// @param header 头部值，如 "bytes=0-499, -500"
+/// @param size 资源大小
+/// @param ranges 返回的字节范围
+/// @param maxRanges 范围个数上限，超出时忽略整个请求头
+/// @return 范围个数；0表示应忽略Range（格式错误、数值溢出或不支持），-1表示均不可满足（416）
+int parseRanges(const char* header, size_t size, std::vector<AsyncByteRange>& ranges, size_t maxRanges)
+{
+    ranges.clear();
+    if (strncasecmp(header, "bytes=", 6) != 0) {
+        return 0;
+    }
+    auto* p = header + 6;
+    bool any = false;       // 至少有一项语法正确
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        bool hasFirst = false, hasLast = false;
+        size_t first = 0, last = 0;
+        while (*p >= '0' && *p <= '9') {
+            if (__builtin_mul_overflow(first, 10, &first) || __builtin_add_overflow(first, *p++ - '0', &first)) {
+                return 0;   // 数值溢出，按格式错误处理
+            }
+            hasFirst = true;
+        }
+        if (*p++ != '-') {
+            return 0;
+        }
+        while (*p >= '0' && *p <= '9') {
+            if (__builtin_mul_overflow(last, 10, &last) || __builtin_add_overflow(last, *p++ - '0', &last)) {
+                return 0;   // 数值溢出，按格式错误处理
+            }
+            hasLast = true;
+        }
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if ((*p != ',' && *p != '\0') || (!hasFirst && !hasLast) || (hasFirst && hasLast && last < first)) {
+            return 0;
+        }
+        any = true;
+
+        AsyncByteRange range;
+        if (!hasFirst) {
+            // 后缀范围：最后last字节
+            if (last == 0 || size == 0) {
+                continue;
+            }
+            range.length = std::min(last, size);
+            range.offset = size - range.length;
+        } else {
+            if (first >= size) {
+                continue;
+            }
+            range.offset = first;
+            range.length = (hasLast && last < size ? last + 1 : size) - first;
+        }
+        if (ranges.size() >= maxRanges) {
+            return 0;
+        }
+        ranges.push_back(range);
+    }
+    if (ranges.empty()) {
+        return any ? -1 : 0;
+    }
+
+    // 排序并合并重叠或相邻的范围
+    std::sort(ranges.begin(), ranges.end(), [](const AsyncByteRange& a, const AsyncByteRange& b) {
+        return a.offset < b.offset;
+    });
+    size_t n = 0;
+    for (size_t i = 1; i < ranges.size(); i++) {
+        auto end = ranges[n].offset + ranges[n].length;
+        if (ranges[i].offset <= end) {
+            end = std::max(end, ranges[i].offset + ranges[i].length);
+            ranges[n].length = end - ranges[n].offset;
+        } else {
+            ranges[++n] = ranges[i];
+        }
+    }
+    ranges.resize(n + 1);
+    return ranges.size();
+}
+
+/// @brief 解析q值（"0"~"1"，最多三位小数）
+/// @return q值的千分数，格式错误时按1处理
+static int parseQuality(const char* p)
+{
+    if (*p != '0') {
+        return 1000;
+    }
+    int q = 0;
+    if (*++p == '.') {
+        int scale = 100;
+        while (scale && isdigit((uint8_t)*++p)) {
+            q += (*p - '0') * scale;
+            scale /= 10;
+        }
+    }
+    return q;
+}
+
+/// @brief 求Accept-Encoding（RFC 7231 5.3.4）中某内容编码的q值
+/// @param header 头部值，如 "br;q=1.0, gzip;q=0.8, *;q=0"
+/// @param coding 内容编码，如 "br"、"gzip"、"identity"
+/// @return q值的千分数（0表示不可接受）；未列出时按"*"的q值，identity未列出且无"*"时可接受但优先级最低（1）
+int encodingQuality(const char* header, const char* coding)
+{
+    auto codingLen = strlen(coding);
+    int star = -1;
+    auto* p = header;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        auto* name = p;
+        while (*p && *p != ',' && *p != ';' && *p != ' ' && *p != '\t') {
+            p++;
+        }
+        size_t nameLen = p - name;
+        if (nameLen == 0) {
+            if (*p && *p != ',') {
+                p++;
+            }
+            continue;
+        }
+        int q = 1000;
+        while (*p && *p != ',') {
+            if (*p++ != ';') {
+                continue;
+            }
+            while (*p == ' ' || *p == '\t') {
+                p++;
+            }
+            if ((*p == 'q' || *p == 'Q') && p[1] == '=') {
+                q = parseQuality(p + 2);
+            }
+        }
+        if (nameLen == codingLen && strncasecmp(name, coding, nameLen) == 0) {
+            return q;
+        }
+        if (nameLen == 1 && *name == '*') {
+            star = q;
+        }
+    }
+    if (star >= 0) {
+        return star;
+    }
+    return strcasecmp(coding, "identity") == 0 ? 1 : 0;
+}
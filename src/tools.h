@@ -2,11 +2,25 @@
 #define TOOLS_H_
 
 #include <string>
+#include <vector>
+#include <time.h>
+
+/// @brief 字节范围（Range请求中的一项，已按资源大小换算）
+struct AsyncByteRange {
+    size_t  offset;     // 起始偏移
+    size_t  length;     // 长度
+};
 
 extern const std::string empty_string;
 extern bool FILE_IS_REAL(const char* path);
 extern bool FILE_EXISTS(const char* path);
 extern bool strContains(std::string src, std::string find, bool ignoreCase=true);
+extern size_t formatHttpDate(time_t t, char* buf);
+extern bool etagMatches(const char* header, const std::string& etag, bool weak=true);
+extern time_t parseHttpDate(const char* str);
+extern bool ifRangeMatches(const char* value, const std::string& etag, time_t lastModified);
+extern int parseRanges(const char* header, size_t size, std::vector<AsyncByteRange>& ranges, size_t maxRanges);
+extern int encodingQuality(const char* header, const char* coding);
 
 
 #endif // !TOOLS_H_
\ No newline at end of file